@@ -0,0 +1,71 @@
+#ifndef MyAnalysis_BootstrapReplicas_H
+#define MyAnalysis_BootstrapReplicas_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifndef MYANALYSIS_KERNELS_ONLY
+class TH1;
+class TH2D;
+#endif
+
+/**
+ * Poisson bootstrap replicas of the phiCP Fourier moments of one channel.
+ *
+ * Every event enters each replica with a Poisson(1) weight. The weights come
+ * from a counter-based generator keyed by the event number, so an event gets
+ * the same weights in whichever job processes it, and replicas of parallel
+ * jobs merge by adding their sums. The spread of the replica estimates is the
+ * bootstrap uncertainty of the amplitude and phase of 1 + A cos(phi + C).
+ *
+ * The sums are stored replica-major per moment, so adding an event is a SIMD
+ * loop over the replicas.
+ */
+class BootstrapReplicas {
+public:
+  enum Sum { SUM_W, SUM_WCOS, SUM_WSIN, SUM_COUNT };
+
+  explicit BootstrapReplicas(std::size_t nReplicas = 0);
+
+  std::size_t size() const { return m_nReplicas; }
+
+  /**
+   * Poisson(1) weights of the event in the replicas [0, nReplicas). They only
+   * depend on the event number, the seed and the replica index.
+   */
+  static void eventWeights(std::uint64_t eventNumber, std::uint64_t seed,
+                           std::size_t nReplicas, float *weights);
+
+  /* Adds phi to every replica with its weight from eventWeights() */
+  void add(double phi, const float *weights);
+
+  void merge(const BootstrapReplicas &other);
+
+  double sum(Sum sum, std::size_t replica) const {
+    return m_sums[sum * m_nReplicas + replica];
+  }
+
+  /* Amplitude and phase in [0, 2 pi) of one replica */
+  void estimate(std::size_t replica, double &amplitude, double &phase) const;
+
+  /**
+   * Standard deviations of the replica amplitudes and phases. Phases are
+   * taken relative to their circular mean, so the spread is not inflated by
+   * the wrap at 2 pi.
+   */
+  void spread(double &amplitudeError, double &phaseError) const;
+
+#ifndef MYANALYSIS_KERNELS_ONLY
+  /* Histogram with one bin per replica and sum, to store the replicas in */
+  TH2D makeHistogram(const char *name) const;
+  void store(TH1 &hist) const;
+  static BootstrapReplicas load(const TH1 &hist);
+#endif
+
+private:
+  std::size_t m_nReplicas;
+  std::vector<double> m_sums;
+};
+
+#endif
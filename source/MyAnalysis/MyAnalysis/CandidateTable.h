@@ -0,0 +1,68 @@
+#ifndef MyAnalysis_CandidateTable_H
+#define MyAnalysis_CandidateTable_H
+
+#include "xAODBase/IParticle.h"
+#include "xAODEventInfo/EventInfo.h"
+#include "xAODTau/TauJet.h"
+#include "xAODTracking/TrackParticle.h"
+#include <MyAnalysis/TauPairProcessor.h>
+#include <MyAnalysis/TruthDecayIndex.h>
+#include <MyAnalysis/Vector.h>
+
+/* Rows of the CandidateTable: the candidates of the tau+ and of the tau- */
+enum CandidateRow { CANDIDATE_POS, CANDIDATE_NEG, CANDIDATE_ROWS };
+
+inline int candidateRow(bool positive) {
+  return positive ? CANDIDATE_POS : CANDIDATE_NEG;
+}
+
+enum CandidateKind {
+  CANDIDATE_NONE,
+  CANDIDATE_TAU_JET,
+  CANDIDATE_ELECTRON,
+  CANDIDATE_MUON
+};
+
+/**
+ * Cache of the two reconstructed candidates of the tau pair of one event, one
+ * row per tau charge, so the EDM is read once per event.
+ *
+ * fill() selects the candidate of every truth tau: the leading tau jet of its
+ * charge if it decayed hadronically, the leading lepton of its flavour and
+ * charge otherwise. The quantities only some channels use are computed by the
+ * channel handlers with the fill*() functions of the rows they need. Values a
+ * row does not have keep their defaults.
+ */
+struct CandidateTable {
+  CandidateKind kind[CANDIDATE_ROWS] = {};
+  const xAOD::IParticle *object[CANDIDATE_ROWS] = {};
+  const xAOD::TauJet *tauJet[CANDIDATE_ROWS] = {};
+  const xAOD::TrackParticle *track[CANDIDATE_ROWS] = {};
+
+  Vec4D p4[CANDIDATE_ROWS] = {};
+  Vec4D trackP4[CANDIDATE_ROWS] = {};
+
+  // Tau jets only: the jet vertex if it has one
+  bool hasVertex[CANDIDATE_ROWS] = {};
+  Vec3D vertex[CANDIDATE_ROWS] = {};
+
+  // Filled on request: the d0 significance of the track, and for rho decays
+  // the sums of the jet tracks and of the neutral PFOs with their upsilon
+  double d0Significance[CANDIDATE_ROWS] = {};
+  Vec4D chargedP4[CANDIDATE_ROWS] = {};
+  Vec4D neutralP4[CANDIDATE_ROWS] = {};
+  double rhoUpsilon[CANDIDATE_ROWS] = {};
+
+  /* Selects the candidates of the truth taus from the event's containers */
+  void fill(const TauPairEvent &event, const TruthDecayIndex &truthDecays);
+
+  /* d0 significance of the track of a filled row */
+  void fillD0Significance(int row, const xAOD::EventInfo *eventInfo);
+
+  /* Track and neutral PFO sums of a tau jet row, for rho decays */
+  void fillRhoSums(int row);
+
+  bool has(int row) const { return object[row] != nullptr; }
+};
+
+#endif
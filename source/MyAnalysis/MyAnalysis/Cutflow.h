@@ -0,0 +1,76 @@
+#ifndef MyAnalysis_Cutflow_H
+#define MyAnalysis_Cutflow_H
+
+#include <MyAnalysis/Utils.h>
+#include <string>
+
+#ifndef MYANALYSIS_KERNELS_ONLY
+class TH1;
+class TH1D;
+#endif
+
+/**
+ * Event selection cuts in the order they are applied. The first three only
+ * need the truth record. Cuts that do not apply to a channel, e.g. the tau
+ * jet vertices for leptonic decays, are passed by all its events.
+ */
+enum Cut {
+  CUT_HIGGS,
+  CUT_TAU_PAIR,
+  CUT_CHANNEL,
+  CUT_PRIMARY_VERTEX,
+  CUT_TAU_JETS,
+  CUT_TAU_VERTICES,
+  CUT_LEPTON,
+  CUT_COUNT
+};
+
+/* Name used in the histogram labels and the table, e.g. "primaryVertex" */
+const char *cutName(Cut cut);
+
+/**
+ * Number of events passing every cut, per channel of the truth decay. Events
+ * failing one of the truth cuts count to channel none.
+ *
+ * Each event is counted once, at the cut it failed, so counting is a single
+ * increment. The cumulative counts can be stored in the bins of a histogram,
+ * which merges correctly when the outputs of parallel jobs are added.
+ */
+class Cutflow {
+public:
+  /* Counts an event that failed the cut */
+  void fail(DecayChannel channel, Cut cut) { m_exits[channel][cut]++; }
+
+  /* Counts an event that passed all cuts */
+  void pass(DecayChannel channel) { m_exits[channel][CUT_COUNT]++; }
+
+  void merge(const Cutflow &other);
+
+  /* All events of the channel, of all channels for CHANNEL_COUNT */
+  unsigned long long events(DecayChannel channel) const;
+
+  /* Events of the channel passing the cut and all cuts before it */
+  unsigned long long passed(DecayChannel channel, Cut cut) const;
+
+#ifndef MYANALYSIS_KERNELS_ONLY
+  /* Histogram with a labelled bin for all events and one per cut */
+  static TH1D makeHistogram(const char *name);
+
+  /* Stores the counts of one channel, or of all for CHANNEL_COUNT */
+  void store(DecayChannel channel, TH1 &hist) const;
+#endif
+
+  /* Events and efficiencies of every channel with events, one cut per line */
+  std::string table() const;
+
+private:
+  /* Events leaving at the cut index, CUT_COUNT for the selected ones */
+  unsigned long long exits(DecayChannel channel, int exit) const;
+  /* Cut index -1 gives all events */
+  unsigned long long passedIndex(DecayChannel channel, int cut) const;
+  void appendTable(DecayChannel channel, std::string &table) const;
+
+  unsigned long long m_exits[CHANNEL_COUNT][CUT_COUNT + 1] = {};
+};
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef MyAnalysis_EventArena_H
+#define MyAnalysis_EventArena_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+
+/* Allocations served by an arena, summed over events and arenas */
+struct ArenaStats {
+  unsigned long long events = 0;
+  unsigned long long allocations = 0;
+  unsigned long long bytes = 0;
+
+  // Requests that did not fit into the buffer and went to the heap, and the
+  // events they happened in
+  unsigned long long heapAllocations = 0;
+  unsigned long long heapBytes = 0;
+  unsigned long long heapEvents = 0;
+
+  /* Most bytes one event used */
+  std::size_t peakBytes = 0;
+
+  void merge(const ArenaStats &other);
+
+  /* One line for the log, e.g. "1000 events, 4000 allocations of ..." */
+  std::string summary() const;
+};
+
+/**
+ * Memory of the transient containers of one event.
+ *
+ * Allocations bump a pointer through a buffer owned by the arena and
+ * deallocations do nothing; reset() at the start of every event frees all of
+ * it at once, so containers must not outlive their event. Requests that do
+ * not fit go to the heap and are counted in the stats. The buffer then grows
+ * at the next reset(), so once the largest event was seen the event loop
+ * allocates nothing.
+ */
+class EventArena : public std::pmr::memory_resource {
+public:
+  explicit EventArena(std::size_t capacity = 16384);
+  ~EventArena() override;
+
+  EventArena(const EventArena &) = delete;
+  EventArena &operator=(const EventArena &) = delete;
+
+  /* Starts a new event, invalidating everything allocated before */
+  void reset();
+
+  /**
+   * Adds the usage of the current event to the stats, which reset() only
+   * does for the event it ends. Call it before reporting the stats at the
+   * end of the job, so the last event counts.
+   */
+  void flushStats();
+
+  std::size_t capacity() const { return m_capacity; }
+  const ArenaStats &stats() const { return m_stats; }
+
+private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void *pointer, std::size_t bytes,
+                     std::size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override;
+
+  /* Frees the heap blocks of the current event */
+  void releaseHeapBlocks();
+
+  struct HeapBlock;
+
+  std::unique_ptr<std::byte[]> m_buffer;
+  std::size_t m_capacity = 0;
+  std::size_t m_used = 0;
+
+  HeapBlock *m_heapBlocks = nullptr;
+  std::size_t m_heapBytes = 0;
+
+  ArenaStats m_stats;
+  /* Whether the current event is not in m_stats yet */
+  bool m_pendingStats = false;
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef MyAnalysis_EventIndex_H
+#define MyAnalysis_EventIndex_H
+
+#include <MyAnalysis/Utils.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Truth decay modes of the tau pair of every entry of one input file.
+ *
+ * buildEventIndex writes it to a sidecar file, next to the input or in an
+ * index directory, so later jobs can skip the entries of other channels
+ * before reading any of their containers. EventLoop still loops over the
+ * skipped entries, so TruthLevelAnalysis applies the event limit itself.
+ * Entries without a H -> tau tau decay have UNKNOWN for both modes.
+ */
+class EventIndex {
+public:
+  /**
+   * Sidecar of an input file, "<input>.eventindex.root". With an index
+   * directory it is "<directory>/<sample>/<file>.eventindex.root" instead,
+   * the sample being the directory of the input.
+   */
+  static std::string sidecarPath(const std::string &inputPath,
+                                 const std::string &directory = "");
+
+  void clear();
+  void add(TauDecayMode tauNeg, TauDecayMode tauPos);
+
+  std::size_t size() const { return m_tauNegModes.size(); }
+  DecayChannel channel(std::size_t entry) const;
+
+  /* Writes or reads the event_index tree of the file, false on failure */
+  bool write(const std::string &path) const;
+  bool read(const std::string &path);
+
+  /* Entries of the selected channels, in increasing order */
+  std::vector<long long> entryList(const bool selected[CHANNEL_COUNT]) const;
+
+private:
+  std::vector<unsigned char> m_tauNegModes;
+  std::vector<unsigned char> m_tauPosModes;
+};
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef MyAnalysis_FourierMoments_H
+#define MyAnalysis_FourierMoments_H
+
+#ifndef MYANALYSIS_KERNELS_ONLY
+class TH1;
+class TH1D;
+#endif
+
+/* Closed form estimate of a FourierMoments accumulator */
+struct FourierMomentResult {
+  double sumWeights = 0.0;
+  /* A and C of 1 + A cos(phi + C), the phase in [0, 2 pi) */
+  double amplitude = 0.0;
+  double phase = 0.0;
+  double amplitudeVariance = 0.0;
+  double phaseVariance = 0.0;
+  double amplitudePhaseCovariance = 0.0;
+};
+
+/**
+ * Streaming estimator of the CP phase from the first Fourier moments of a
+ * phiCP distribution.
+ *
+ * For phiCP distributed as 1 + A cos(phi + C), the weighted means of cos phi
+ * and sin phi are A cos(C) / 2 and -A sin(C) / 2. Only their sums are kept,
+ * so adding an event is O(1) and accumulators of parallel jobs are merged by
+ * adding their sums. The amplitude and phase, and their covariance from the
+ * sample variance of the moments, follow in closed form.
+ *
+ * The sums can be stored in the bins of a histogram, which merges correctly
+ * with the outputs of other jobs.
+ */
+class FourierMoments {
+public:
+  enum Sum {
+    SUM_W,
+    SUM_WCOS,
+    SUM_WSIN,
+    SUM_W2,
+    SUM_W2COS,
+    SUM_W2SIN,
+    SUM_W2COS2,
+    SUM_W2SIN2,
+    SUM_W2COSSIN,
+    SUM_COUNT
+  };
+
+  void add(double phi, double weight = 1.0);
+  void merge(const FourierMoments &other);
+
+  /* Estimate of the accumulated events, all zero without any */
+  FourierMomentResult result() const;
+
+  double sum(Sum sum) const { return m_sums[sum]; }
+
+#ifndef MYANALYSIS_KERNELS_ONLY
+  /* Histogram with one labelled bin per sum, to store the accumulator in */
+  static TH1D makeHistogram(const char *name);
+  void store(TH1 &hist) const;
+  static FourierMoments load(const TH1 &hist);
+#endif
+
+private:
+  double m_sums[SUM_COUNT] = {};
+};
+
+#endif
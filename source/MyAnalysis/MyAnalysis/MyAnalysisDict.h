@@ -4,6 +4,9 @@
 // This file includes all the header files that you need to create
 // dictionaries for.
 
+#include <MyAnalysis/BootstrapReplicas.h>
+#include <MyAnalysis/FourierMoments.h>
+#include <MyAnalysis/NtupleHistogrammer.h>
 #include <MyAnalysis/TruthLevelAnalysis.h>
 
 #endif
\ No newline at end of file
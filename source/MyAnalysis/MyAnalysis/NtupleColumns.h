@@ -0,0 +1,22 @@
+#ifndef MyAnalysis_NtupleColumns_H
+#define MyAnalysis_NtupleColumns_H
+
+#include <ROOT/RDataFrame.hxx>
+#include <string>
+
+/**
+ * Makes the wide phiCP branch names available on a tau_analysis data frame.
+ * Wide ntuples are returned as they are; on compact ones every wide column is
+ * defined from the channel and the phiCP pair, with the -99 sentinel for the
+ * other channels.
+ */
+ROOT::RDF::RNode defineWideColumns(ROOT::RDataFrame &frame);
+
+/* Whether the column is the channel or phiCP pair of the compact layout */
+bool isCompactColumn(const std::string &column);
+
+/* Adds the column as a double, whatever type it is stored as */
+ROOT::RDF::RNode defineDouble(ROOT::RDF::RNode node, const std::string &name,
+                              const std::string &column);
+
+#endif
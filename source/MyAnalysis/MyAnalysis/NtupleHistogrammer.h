@@ -0,0 +1,77 @@
+#ifndef MyAnalysis_NtupleHistogrammer_H
+#define MyAnalysis_NtupleHistogrammer_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class TH1;
+
+/**
+ * Fills the histograms of the plotting script from tau_analysis ntuples.
+ *
+ * All requested histograms of all samples are booked on RDataFrames and
+ * filled in a single event loop, which runs multi-threaded once implicit MT
+ * is enabled. Both output layouts and formats are read, the wide phiCP
+ * branch names are always available.
+ */
+class NtupleHistogrammer {
+public:
+  explicit NtupleHistogrammer(const std::string &name = "tau_analysis");
+  ~NtupleHistogrammer();
+
+  void addSample(const std::string &sample, const std::string &path);
+
+  /**
+   * Only keeps entries with |branch| inside the window. As in the plotting
+   * script, a lower or upper limit of 0 is not applied.
+   */
+  void addCut(const std::string &branch, double lower, double upper);
+
+  void addHistogram(const std::string &histName, const std::string &branch,
+                    int bins, double lower, double upper);
+  void addHistogram2D(const std::string &histName, const std::string &xBranch,
+                      const std::string &yBranch, int xBins, double xLower,
+                      double xUpper, int yBins, double yLower,
+                      double yUpper);
+
+  /* Fills the histograms of all samples in one pass over the events */
+  void run();
+
+  /* Histogram filled by run(), nullptr if it was not requested */
+  TH1 *histogram(const std::string &sample, const std::string &histName) const;
+
+  /**
+   * Branches with at least one value inside [lower, upper] in any sample,
+   * sorted by name. Runs its own pass and ignores the cuts.
+   */
+  std::vector<std::string> branchesInRange(double lower, double upper) const;
+
+private:
+  struct Cut {
+    std::string branch;
+    double lower;
+    double upper;
+  };
+
+  struct Request {
+    std::string histName;
+    std::string xBranch;
+    std::string yBranch;
+    int xBins;
+    double xLower;
+    double xUpper;
+    int yBins;
+    double yLower;
+    double yUpper;
+  };
+
+  std::string m_name;
+  std::vector<std::pair<std::string, std::string>> m_samples;
+  std::vector<Cut> m_cuts;
+  std::vector<Request> m_requests;
+  std::map<std::string, std::map<std::string, std::unique_ptr<TH1>>> m_hists;
+};
+
+#endif
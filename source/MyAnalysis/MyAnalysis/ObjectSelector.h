@@ -0,0 +1,149 @@
+#ifndef MyAnalysis_ObjectSelector_H
+#define MyAnalysis_ObjectSelector_H
+
+#include "xAODEgamma/ElectronContainer.h"
+#include "xAODMuon/MuonContainer.h"
+#include "xAODTau/TauJetContainer.h"
+#include "xAODTracking/TrackParticle.h"
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+/**
+ * Selection policies for the object preselection.
+ *
+ * A policy names the container it applies to, its kinematic acceptance, the
+ * object-specific cuts and the track used for the impact parameter.
+ * Everything is static, so the cuts are compiled into the selection loop.
+ */
+struct TauJetSelection {
+  using Container = xAOD::TauJetContainer;
+  using Object = xAOD::TauJet;
+
+  static constexpr double minPt = 20000.0;
+  static constexpr double maxAbsEta = 2.47;
+  static constexpr bool vetoCrack = true;
+
+  /* Require 1 or 3 tracks and a leading track */
+  static bool passObject(const xAOD::TauJet *jet) {
+    return (jet->nTracks() == 1 || jet->nTracks() == 3) &&
+           jet->track(0) != nullptr && jet->track(0)->track() != nullptr;
+  }
+
+  static const xAOD::TrackParticle *track(const xAOD::TauJet *jet) {
+    return jet->track(0)->track();
+  }
+};
+
+struct ElectronSelection {
+  using Container = xAOD::ElectronContainer;
+  using Object = xAOD::Electron;
+
+  static constexpr double minPt = 20000.0;
+  static constexpr double maxAbsEta = 2.47;
+  static constexpr bool vetoCrack = true;
+
+  /* Require exactly one track */
+  static bool passObject(const xAOD::Electron *electron) {
+    return electron->nTrackParticles() == 1 &&
+           electron->trackParticle(0) != nullptr;
+  }
+
+  static const xAOD::TrackParticle *track(const xAOD::Electron *electron) {
+    return electron->trackParticle(0);
+  }
+};
+
+struct MuonSelection {
+  using Container = xAOD::MuonContainer;
+  using Object = xAOD::Muon;
+
+  static constexpr double minPt = 20000.0;
+  static constexpr double maxAbsEta = 2.5;
+  static constexpr bool vetoCrack = false;
+
+  /* Require a primary track */
+  static bool passObject(const xAOD::Muon *muon) {
+    return muon->primaryTrackParticle() != nullptr;
+  }
+
+  static const xAOD::TrackParticle *track(const xAOD::Muon *muon) {
+    return muon->primaryTrackParticle();
+  }
+};
+
+/* Skips objects outside the barrel and endcap regions or below the pT cut */
+template <typename Policy> bool PassKinematics(const xAOD::IParticle *object) {
+  const double absEta = std::abs(object->eta());
+  if (object->pt() < Policy::minPt || absEta > Policy::maxAbsEta) {
+    return false;
+  }
+  return !Policy::vetoCrack || absEta <= 1.37 || absEta >= 1.52;
+}
+
+/* The N highest-pT objects of each charge, ordered by decreasing pT */
+template <typename Object, std::size_t N = 1> struct ChargedCandidates {
+  std::array<const Object *, N> positive{};
+  std::array<const Object *, N> negative{};
+
+  /* Leading object of the given charge or nullptr */
+  const Object *leading(bool isPositive) const {
+    return isPositive ? positive[0] : negative[0];
+  }
+};
+
+/**
+ * Selects the leading candidates of both charges in a single pass over the
+ * container. Neutral objects are skipped. Objects with equal pT keep their
+ * container order.
+ */
+template <typename Policy, std::size_t N = 1>
+ChargedCandidates<typename Policy::Object, N>
+SelectCandidates(const typename Policy::Container *objects) {
+  using Object = typename Policy::Object;
+  ChargedCandidates<Object, N> candidates;
+
+  for (const Object *object : *objects) {
+    if (object->charge() == 0 || !Policy::passObject(object) ||
+        !PassKinematics<Policy>(object)) {
+      continue;
+    }
+
+    // Insert into the pT-ordered list of its charge
+    std::array<const Object *, N> &ranked =
+        object->charge() > 0 ? candidates.positive : candidates.negative;
+    const Object *current = object;
+    for (const Object *&slot : ranked) {
+      if (slot == nullptr) {
+        slot = current;
+        break;
+      }
+      if (current->pt() > slot->pt()) {
+        std::swap(slot, current);
+      }
+    }
+  }
+
+  return candidates;
+}
+
+/* A reconstructed lepton with the track used for the impact parameter */
+struct RecoLepton {
+  const xAOD::IParticle *particle = nullptr;
+  const xAOD::TrackParticle *track = nullptr;
+};
+
+/* Leading reconstructed electron or muon of the given charge */
+template <typename Policy>
+RecoLepton SelectLeadingLepton(const typename Policy::Container *objects,
+                               bool positive) {
+  const typename Policy::Object *lepton =
+      SelectCandidates<Policy>(objects).leading(positive);
+  if (lepton == nullptr) {
+    return {};
+  }
+  return {lepton, Policy::track(lepton)};
+}
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef MyAnalysis_PhiCPHistograms_H
+#define MyAnalysis_PhiCPHistograms_H
+
+#include <MyAnalysis/TauAnalysisRecord.h>
+#include <MyAnalysis/Utils.h>
+#include <functional>
+#include <string>
+
+class TH1;
+class TH1F;
+
+/**
+ * Per-channel truth and recon phiCP histograms, filled from the records of
+ * the selected events.
+ *
+ * Every channel has an inclusive histogram and one for each cut variant. All
+ * use the fixed binning of the plotting script and unit weights, so the
+ * outputs of parallel jobs merge into the histograms of the full sample.
+ */
+class PhiCPHistograms {
+public:
+  enum Variant { VARIANT_INCLUSIVE, VARIANT_D0SIG, VARIANT_YY, VARIANT_COUNT };
+
+  struct Cuts {
+    /* Minimum |d0 significance| of every track it was computed for */
+    double d0Sig = 3.0;
+    /* Minimum |y+ y-| of the two tau tracks */
+    double yy = 0.1;
+  };
+
+  static const int BINS = 50;
+
+  /* Histogram name, e.g. phiCP_1p1n_1p1n_recon_yy */
+  static std::string name(DecayChannel channel, bool truth, Variant variant);
+
+  /**
+   * Creates all histograms. The callback registers each of them with the
+   * output and returns the registered copy, or nullptr on failure, in which
+   * case false is returned.
+   */
+  bool book(const Cuts &cuts,
+            const std::function<TH1 *(const TH1F &)> &registerHist);
+
+  void fill(const TauAnalysisRecord &record) const;
+
+private:
+  bool passes(const TauAnalysisRecord &record, Variant variant) const;
+
+  Cuts m_cuts;
+  TH1 *m_hists[CHANNEL_COUNT][2][VARIANT_COUNT] = {};
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef MyAnalysis_PhiCPVariation_H
+#define MyAnalysis_PhiCPVariation_H
+
+#include <string>
+#include <vector>
+
+/**
+ * Reference frame the reconstructed phiCP is computed in. NOMINAL is the one
+ * of the channel: the charged pair for pion-pion and rho-rho, the pair of
+ * candidate four-momenta otherwise.
+ */
+enum VariationFrame {
+  FRAME_NOMINAL,
+  FRAME_VISIBLE,
+  FRAME_CANDIDATES,
+  FRAME_TRUTH_TAUS
+};
+
+/* Origin of the reconstructed impact parameters, w.r.t. the beam spot */
+enum VariationOrigin { ORIGIN_JET_VERTEX, ORIGIN_PRIMARY_VERTEX };
+
+/**
+ * Alternative choices of the phiCP reconstruction, evaluated next to the
+ * nominal one on the same event. A default constructed variation is the
+ * nominal reconstruction.
+ */
+struct PhiCPVariation {
+  std::string name;
+  VariationFrame frame = FRAME_NOMINAL;
+  VariationOrigin origin = ORIGIN_JET_VERTEX;
+  /* Whether the leptonic channels are shifted by pi */
+  bool leptonicShift = true;
+};
+
+/* Most variations a job evaluates, the record keeps one value for each */
+const int MAX_PHICP_VARIATIONS = 8;
+
+/**
+ * Parses a comma-separated list of variations. Each variation is named by its
+ * settings joined by underscores, e.g. "truthtaus_pv" or "visible_noshift":
+ *
+ *   visible, candidates, truthtaus  reference frame, see VariationFrame
+ *   jetvertex, pv                   impact parameter origin
+ *   noshift                         no pi shift of the leptonic channels
+ *
+ * Settings that are not given keep the nominal choice. Returns false for an
+ * unknown setting, a name giving two frames, two origins or a setting twice
+ * (e.g. "visible_candidates"), two variations with the same settings (e.g.
+ * "pv,pv" or "pv_noshift,noshift_pv") or more than MAX_PHICP_VARIATIONS
+ * variations.
+ */
+bool parseVariationList(const std::string &list,
+                        std::vector<PhiCPVariation> &variations);
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef MyAnalysis_StageTimers_H
+#define MyAnalysis_StageTimers_H
+
+#include <MyAnalysis/Utils.h>
+#include <chrono>
+#include <functional>
+#include <string>
+
+class TH1;
+class TH1D;
+
+/**
+ * Stages of the event processing:
+ *
+ *   SELECTION          candidate selection into the CandidateTable and the
+ *                      channel's cuts on it
+ *   IMPACT_PARAMETERS  truth impact parameters, the d0 significances and, for
+ *                      rho decays, the momentum sums of the decay planes
+ *   PHICP              truth phiCP, and the reconstructed impact parameters
+ *                      with the phiCP of the nominal and every variation,
+ *                      which are computed together
+ *   OUTPUT             the output record, histograms and moments of the event
+ */
+enum TimedStage {
+  STAGE_RETRIEVE_TRUTH,
+  STAGE_TRUTH_DECAYS,
+  STAGE_RETRIEVE_RECO,
+  STAGE_PRIMARY_VERTEX,
+  STAGE_SELECTION,
+  STAGE_IMPACT_PARAMETERS,
+  STAGE_PHICP,
+  STAGE_OUTPUT,
+  STAGE_COUNT
+};
+
+/* Name used in the histogram names, e.g. "selection" */
+const char *timedStageName(TimedStage stage);
+
+/**
+ * Wall time spent in the stages of one event, taken as laps: lap() books the
+ * time since the previous lap, or since start(), to the stage. A stage can
+ * get several laps in one event.
+ */
+class StageClock {
+public:
+  void start() {
+    for (double &time : m_ns) {
+      time = 0.0;
+    }
+    m_lapped = 0;
+    m_last = Clock::now();
+  }
+
+  void lap(TimedStage stage) {
+    Clock::time_point now = Clock::now();
+    m_ns[stage] +=
+        std::chrono::duration<double, std::nano>(now - m_last).count();
+    m_lapped |= 1u << stage;
+    m_last = now;
+  }
+
+  bool lapped(TimedStage stage) const { return m_lapped & (1u << stage); }
+  double ns(TimedStage stage) const { return m_ns[stage]; }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  Clock::time_point m_last;
+  double m_ns[STAGE_COUNT] = {};
+  unsigned m_lapped = 0;
+};
+
+/* Laps the stage on the clock, timing is disabled by a null clock */
+inline void lapStage(StageClock *clock, TimedStage stage) {
+  if (clock != nullptr) {
+    clock->lap(stage);
+  }
+}
+
+/**
+ * Per-channel distributions of the stage times.
+ *
+ * The times are filled into histograms with logarithmic bins from 1 ns to
+ * 10 s, whose statistics keep the exact mean, so the outputs of parallel jobs
+ * merge. Events excluded by their truth decay are kept as channel none.
+ */
+class StageTimers {
+public:
+  struct Summary {
+    double events = 0.0;
+    /* In ns, the percentiles interpolated within their bins */
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p99 = 0.0;
+  };
+
+  /* Histogram name, e.g. stageTime_1p0n_1p0n_selection */
+  static std::string name(DecayChannel channel, TimedStage stage);
+
+  /**
+   * Creates all histograms. The callback registers each of them with the
+   * output and returns the registered copy, or nullptr on failure, in which
+   * case false is returned.
+   */
+  bool book(const std::function<TH1 *(const TH1D &)> &registerHist);
+
+  /* Fills the stages the clock lapped in the event */
+  void fill(DecayChannel channel, const StageClock &clock) const;
+
+  Summary summary(DecayChannel channel, TimedStage stage) const;
+
+private:
+  TH1 *m_hists[CHANNEL_COUNT][STAGE_COUNT] = {};
+};
+
+#endif
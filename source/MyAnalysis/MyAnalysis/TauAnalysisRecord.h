@@ -0,0 +1,36 @@
+#ifndef MyAnalysis_TauAnalysisRecord_H
+#define MyAnalysis_TauAnalysisRecord_H
+
+#include <MyAnalysis/PhiCPVariation.h>
+#include <MyAnalysis/Utils.h>
+#include <algorithm>
+
+/**
+ * Output values of one event: the channel the event was reconstructed in, its
+ * truth and reconstructed phiCP and the cut variables. Values not computed for
+ * the event keep the -99 sentinel, so a default constructed record is a reset
+ * one.
+ */
+struct TauAnalysisRecord {
+  TauAnalysisRecord() {
+    std::fill_n(phiCP_recon_variations, MAX_PHICP_VARIATIONS, -99.0);
+  }
+
+  DecayChannel channel = CHANNEL_NONE;
+  double phiCP_truth = -99.0;
+  double phiCP_recon = -99.0;
+
+  // Reconstructed phiCP of the variations of the processor, in their order
+  double phiCP_recon_variations[MAX_PHICP_VARIATIONS];
+
+  double d0_sig_tau_pos_track = -99.0;
+  double d0_sig_tau_neg_track = -99.0;
+
+  double y_tau_pos_track = -99.0;
+  double y_tau_neg_track = -99.0;
+  double yy_tau_tracks = -99.0;
+
+  double tau_jets_vtx_diff = -99.0;
+};
+
+#endif
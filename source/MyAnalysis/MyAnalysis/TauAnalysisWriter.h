@@ -0,0 +1,126 @@
+#ifndef MyAnalysis_TauAnalysisWriter_H
+#define MyAnalysis_TauAnalysisWriter_H
+
+#include <MyAnalysis/TauAnalysisRecord.h>
+#include <MyAnalysis/Utils.h>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class TDirectory;
+class TTree;
+
+/**
+ * Branch layout of the tau_analysis tree.
+ *
+ * WIDE has a truth and recon double per channel, of which all but one hold
+ * the -99 sentinel. COMPACT stores the channel and a single float phiCP pair,
+ * with tree aliases providing the WIDE branch names for TTree::Draw.
+ */
+enum OutputLayout { LAYOUT_WIDE, LAYOUT_COMPACT };
+
+/* Parses "wide" or "compact", returns false for anything else */
+bool parseOutputLayout(const std::string &name, OutputLayout &layout);
+
+/**
+ * Storage format of the tau_analysis output. TTREE writes a classic tree,
+ * RNTUPLE the same fields as columns of an RNTuple.
+ */
+enum OutputFormat { FORMAT_TTREE, FORMAT_RNTUPLE };
+
+/* Parses "ttree" or "rntuple", returns false for anything else */
+bool parseOutputFormat(const std::string &name, OutputFormat &format);
+
+/**
+ * Writes TauAnalysisRecords to the tau_analysis tree.
+ *
+ * Records are collected in one buffer per event slot and only moved into the
+ * output, under a lock, when a buffer is full or on flush(). Concurrent events
+ * therefore never share state, as long as each slot is used by one thread at
+ * a time, which is what the schedulers guarantee.
+ */
+class TauAnalysisWriter {
+public:
+  struct Options {
+    OutputLayout layout = LAYOUT_WIDE;
+    /* TTree basket size in bytes, 0 keeps the ROOT default */
+    int basketSize = 0;
+    /* RNTuple page and cluster size in bytes, 0 keeps the ROOT default */
+    std::size_t pageSize = 0;
+    std::size_t clusterSize = 0;
+    /* ROOT compression settings (algorithm * 100 + level), -1 keeps the
+     * settings of the output file */
+    int compression = -1;
+    std::size_t nSlots = 1;
+    /* Number of records each slot holds before they are written */
+    std::size_t bufferSize = 1024;
+    /* Names of the phiCP variations of the records, each written to a
+     * phiCP_recon_<name> column */
+    std::vector<std::string> variations;
+  };
+
+  TauAnalysisWriter();
+  ~TauAnalysisWriter();
+
+  /* Creates the output branches on the tree and one buffer per slot */
+  void attach(TTree *tree, const Options &options);
+
+  /* Creates an RNTuple of the given name in the directory instead */
+  void attach(TDirectory *directory, const std::string &name,
+              const Options &options);
+
+  void write(std::size_t slot, const TauAnalysisRecord &record);
+
+  /* Writes all buffered records of all slots to the output */
+  void flush();
+
+  /**
+   * Flushes and, for an RNTuple, commits it to its directory. Must be called
+   * before the output file is closed; nothing may be written afterwards.
+   */
+  void close();
+
+private:
+  struct NTupleSink;
+
+  void setUp(const Options &options);
+
+  /* Calls visitor(name, address) for every output column of the layout */
+  template <class Visitor> void visitColumns(Visitor &&visitor);
+
+  /* Sets aliases for the wide branch names on a compact tree */
+  void aliasCompact(TTree *tree);
+
+  /* Fills the output from the buffer and empties it, needs m_mutex */
+  void fill(std::vector<TauAnalysisRecord> &buffer);
+
+  OutputLayout m_layout = LAYOUT_WIDE;
+  std::vector<std::string> m_variations;
+  std::size_t m_bufferSize = 1;
+  TTree *m_tree = nullptr;
+  std::unique_ptr<NTupleSink> m_ntuple;
+  std::vector<std::vector<TauAnalysisRecord>> m_buffers;
+  std::mutex m_mutex;
+
+  // Column values of the wide layout, the cut variables share m_record
+  TauAnalysisRecord m_record;
+  double m_phiCP[CHANNEL_COUNT][2] = {};
+
+  // Column values of the compact layout
+  struct CompactValues {
+    unsigned char channel = CHANNEL_NONE;
+    float phiCP_truth = -99.0f;
+    float phiCP_recon = -99.0f;
+    float d0_sig_tau_pos_track = -99.0f;
+    float d0_sig_tau_neg_track = -99.0f;
+    float y_tau_pos_track = -99.0f;
+    float y_tau_neg_track = -99.0f;
+    float yy_tau_tracks = -99.0f;
+    float tau_jets_vtx_diff = -99.0f;
+    float phiCP_recon_variations[MAX_PHICP_VARIATIONS] = {};
+  } m_compact;
+};
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef MyAnalysis_TauPairProcessor_H
+#define MyAnalysis_TauPairProcessor_H
+
+#include "AsgMessaging/AsgMessaging.h"
+#include "xAODEgamma/ElectronContainer.h"
+#include "xAODEventInfo/EventInfo.h"
+#include "xAODMuon/MuonContainer.h"
+#include "xAODTau/TauJetContainer.h"
+#include "xAODTracking/VertexContainer.h"
+#include "xAODTruth/TruthParticleContainer.h"
+#include <MyAnalysis/Cutflow.h>
+#include <MyAnalysis/PhiCPVariation.h>
+#include <MyAnalysis/StageTimers.h>
+#include <MyAnalysis/TauAnalysisRecord.h>
+#include <MyAnalysis/TruthDecayIndex.h>
+#include <string>
+#include <vector>
+
+/**
+ * Reconstruction containers of an event, as bit flags. classify() returns the
+ * ones the event's channel needs, so the algorithm only reads those.
+ */
+enum RecoContainer : unsigned {
+  RECO_NONE = 0,
+  RECO_EVENT_INFO = 1u << 0,
+  RECO_VERTICES = 1u << 1,
+  RECO_TAU_JETS = 1u << 2,
+  RECO_ELECTRONS = 1u << 3,
+  RECO_MUONS = 1u << 4
+};
+
+const int RECO_CONTAINER_COUNT = 5;
+
+/* Store key of the i-th container flag, e.g. "TauJets" for RECO_TAU_JETS */
+const char *recoContainerName(int index);
+
+/**
+ * Channel of a tau pair by the decay modes of the tau- and tau+, CHANNEL_NONE
+ * for the pairs the analysis does not reconstruct. Taken from the channel
+ * table of TauPairProcessor, which also dispatches the channels.
+ */
+DecayChannel decayChannelOf(TauDecayMode tauNeg, TauDecayMode tauPos);
+
+/**
+ * The containers of one event, retrieved by the calling algorithm. The truth
+ * containers are always set, the reconstruction containers only if classify()
+ * asked for them.
+ */
+struct TauPairEvent {
+  const xAOD::EventInfo *eventInfo = nullptr;
+  const xAOD::TruthParticleContainer *truthHiggs = nullptr;
+  const xAOD::TruthParticleContainer *truthTaus = nullptr;
+  const xAOD::TauJetContainer *tauJets = nullptr;
+  const xAOD::ElectronContainer *electrons = nullptr;
+  const xAOD::MuonContainer *muons = nullptr;
+  const xAOD::VertexContainer *vertices = nullptr;
+};
+
+/**
+ * Event selection and phiCP reconstruction of the H -> tau tau analysis.
+ *
+ * An event is handled in two stages: classify() selects it from the truth
+ * record alone, and only the events it accepts are passed to process() with
+ * their reconstruction containers. process() dispatches on the decay modes of
+ * the tau- and the tau+ through a table of channel handlers, built at compile
+ * time. All per-event state lives in the arguments, so a single processor can
+ * be shared by concurrent events.
+ *
+ * Next to the nominal phiCP, the reconstructed phiCP of every configured
+ * variation is computed from the same candidates, so one pass over the input
+ * gives all of them.
+ */
+class TauPairProcessor : public asg::AsgMessaging {
+public:
+  explicit TauPairProcessor(const std::string &name);
+
+  /**
+   * Finds the Higgs and tau decays of the truth containers and returns the
+   * RecoContainer flags the event's channel needs. If the event is excluded,
+   * RECO_NONE is returned and the failed cut set. The decay index is scratch
+   * space for the truth decay and may be reused between events.
+   */
+  unsigned classify(const TauPairEvent &event, TruthDecayIndex &truthDecays,
+                    Cut &failedCut) const;
+
+  /**
+   * Computes the observables of an event accepted by classify() into the
+   * record, with the decay index classify() filled. Returns false and sets
+   * the failed cut if the event is excluded. If a clock is given, the stages
+   * are lapped on it.
+   */
+  bool process(const TauPairEvent &event, const TruthDecayIndex &truthDecays,
+               TauAnalysisRecord &record, Cut &failedCut,
+               StageClock *clock = nullptr) const;
+
+  /* Sets the variations process() evaluates, at most MAX_PHICP_VARIATIONS */
+  void setVariations(const std::vector<PhiCPVariation> &variations);
+
+  const std::vector<PhiCPVariation> &variations() const {
+    return m_variations;
+  }
+
+private:
+  std::vector<PhiCPVariation> m_variations;
+};
+
+#endif
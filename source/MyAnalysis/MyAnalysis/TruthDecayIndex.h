@@ -0,0 +1,79 @@
+#ifndef MyAnalysis_TruthDecayIndex_H
+#define MyAnalysis_TruthDecayIndex_H
+
+#include "xAODTruth/TruthParticleContainer.h"
+#include <MyAnalysis/Utils.h>
+#include <MyAnalysis/Vector.h>
+#include <memory_resource>
+#include <vector>
+
+/**
+ * A truth particle with its four-momentum and production vertex cached. Slimmed
+ * truth records may drop the vertex, the cached one is then only a sentinel.
+ */
+struct TruthParticleRecord {
+  const xAOD::TruthParticle *particle = nullptr;
+  Vec4D p4{0.0, 0.0, 0.0, 0.0};
+  Vec3D productionVertex{0.0, 0.0, 0.0};
+  bool hasProductionVertex = false;
+};
+
+/* The decay products of one tau, grouped by species */
+struct TauDecay {
+  explicit TauDecay(std::pmr::memory_resource *memory)
+      : chargedPions(memory), neutralPions(memory), leptons(memory) {}
+
+  TruthParticleRecord tau;
+  std::pmr::vector<TruthParticleRecord> chargedPions;
+  std::pmr::vector<TruthParticleRecord> neutralPions;
+  std::pmr::vector<TruthParticleRecord> leptons;
+  int neutrinoCount = 0;
+
+  /* Sum of the neutral pion four-momenta */
+  Vec4D neutralPionsP4{0.0, 0.0, 0.0, 0.0};
+  TauDecayMode decayMode = UNKNOWN;
+
+  /* Leading charged pion or lepton, only valid for the matching decay modes */
+  const TruthParticleRecord &chargedPion() const { return chargedPions.back(); }
+  const TruthParticleRecord &lepton() const { return leptons.back(); }
+};
+
+/**
+ * Per-event index of the H -> tau tau truth decay.
+ *
+ * Both containers are walked once, each particle's parent is looked up once
+ * and every four-momentum and production vertex is read from the EDM once.
+ * The child vectors are allocated from the given memory: either the index is
+ * kept across events and rebuilt for each of them, so the vectors keep their
+ * capacity, or it is built per event on that event's EventArena.
+ */
+class TruthDecayIndex {
+public:
+  explicit TruthDecayIndex(
+      std::pmr::memory_resource *memory = std::pmr::get_default_resource())
+      : m_tauPos(memory), m_tauNeg(memory) {}
+
+  /* Finds the Higgs boson and its tau daughters, see higgs() and tauCount() */
+  void findHiggsDecay(const xAOD::TruthParticleContainer *particles);
+
+  /* Collects the children of both taus and classifies their decay modes */
+  void indexTauDecays(const xAOD::TruthParticleContainer *particles);
+
+  const xAOD::TruthParticle *higgs() const { return m_higgs; }
+  int tauCount() const { return m_tauCount; }
+  bool hasTauPair() const {
+    return m_tauPos.tau.particle != nullptr &&
+           m_tauNeg.tau.particle != nullptr && m_tauCount == 2;
+  }
+
+  const TauDecay &tauPos() const { return m_tauPos; }
+  const TauDecay &tauNeg() const { return m_tauNeg; }
+
+private:
+  const xAOD::TruthParticle *m_higgs = nullptr;
+  int m_tauCount = 0;
+  TauDecay m_tauPos;
+  TauDecay m_tauNeg;
+};
+
+#endif
@@ -2,6 +2,18 @@
 #define MyAnalysis_TruthLevelAnalysis_H
 
 #include <AnaAlgorithm/AnaAlgorithm.h>
+#include <MyAnalysis/BootstrapReplicas.h>
+#include <MyAnalysis/Cutflow.h>
+#include <MyAnalysis/EventArena.h>
+#include <MyAnalysis/EventIndex.h>
+#include <MyAnalysis/FourierMoments.h>
+#include <MyAnalysis/PhiCPHistograms.h>
+#include <MyAnalysis/StageTimers.h>
+#include <MyAnalysis/TauAnalysisWriter.h>
+#include <MyAnalysis/TauPairProcessor.h>
+#include <vector>
+
+class TH1;
 
 class TruthLevelAnalysis : public EL::AnaAlgorithm {
 public:
@@ -9,36 +21,81 @@ public:
 
   virtual StatusCode initialize() override;
   virtual StatusCode execute() override;
+  virtual StatusCode beginInputFile() override;
   virtual StatusCode finalize() override;
 
 private:
-  double m_phiCP_lept_1p0n_truth = 0.;
-  double m_phiCP_lept_1p0n_recon = 0.;
-  double m_phiCP_lept_1p1n_truth = 0.;
-  double m_phiCP_lept_1p1n_recon = 0.;
-  double m_phiCP_lept_1pXn_truth = 0.;
-  double m_phiCP_lept_1pXn_recon = 0.;
-
-  double m_phiCP_1p0n_1p0n_truth = 0.;
-  double m_phiCP_1p0n_1p0n_recon = 0.;
-  double m_phiCP_1p0n_1p1n_truth = 0.;
-  double m_phiCP_1p0n_1p1n_recon = 0.;
-  double m_phiCP_1p0n_1pXn_truth = 0.;
-  double m_phiCP_1p0n_1pXn_recon = 0.;
-
-  double m_phiCP_1p1n_1p1n_truth = 0.;
-  double m_phiCP_1p1n_1p1n_recon = 0.;
-  double m_phiCP_1p1n_1pXn_truth = 0.;
-  double m_phiCP_1p1n_1pXn_recon = 0.;
-
-  double m_d0_sig_tau_pos_track = 0.;
-  double m_d0_sig_tau_neg_track = 0.;
-
-  double m_y_tau_pos_track = 0.;
-  double m_y_tau_neg_track = 0.;
-  double m_yy_tau_tracks = 0.;
-
-  double m_tau_jets_vtx_diff = 0.;
+  /* Registers a histogram with the ANALYSIS output, nullptr on failure */
+  TH1 *registerHist(const TH1 &prototype);
+
+  /* Retrieves the reconstruction containers of the RecoContainer flags */
+  StatusCode retrieveReco(unsigned containers, TauPairEvent &event);
+
+  /* Prints the xAOD read statistics of the input containers */
+  void printReadStats() const;
+
+  /* Prints the mean, median and 99th percentile of every stage and channel */
+  void printStageTimes() const;
+
+  std::string m_outputFormat;
+  std::string m_outputLayout;
+  int m_basketSize = 0;
+  int m_pageSize = 0;
+  int m_clusterSize = 0;
+
+  bool m_fillHistograms = false;
+  double m_d0SigCut = 3.0;
+  double m_yyCut = 0.1;
+  bool m_fillFourierMoments = false;
+  int m_bootstrapReplicas = 0;
+  int m_bootstrapSeed = 0;
+  int m_compression = -1;
+
+  bool m_printReadStats = false;
+
+  // Per-stage wall time of the events, only kept with TimeStages set
+  bool m_timeStages = false;
+  StageClock m_clock;
+  StageTimers m_stageTimers;
+
+  // Channel filter and the entries of the current input file it selects
+  std::string m_channels;
+  std::string m_eventIndexDir;
+  bool m_selectedChannels[CHANNEL_COUNT] = {};
+  std::vector<long long> m_entryList;
+
+  // Limit on the selected entries and the ones processed so far
+  int m_eventLimit = -1;
+  long long m_selectedEvents = 0;
+
+  // Variations of the reconstructed phiCP evaluated on every event
+  std::string m_variations;
+
+  TauPairProcessor m_processor;
+  TauAnalysisWriter m_writer;
+  PhiCPHistograms m_histograms;
+
+  // Truth and recon phiCP moments per channel and the histograms storing them
+  FourierMoments m_moments[CHANNEL_COUNT][2];
+  TH1 *m_momentHists[CHANNEL_COUNT][2] = {};
+
+  // Bootstrap replicas of the same moments and the event's replica weights
+  BootstrapReplicas m_bootstrap[CHANNEL_COUNT][2];
+  TH1 *m_bootstrapHists[CHANNEL_COUNT][2] = {};
+  std::vector<float> m_bootstrapWeights;
+
+  // Events passing each cut and the histograms storing them, the last one
+  // for all channels
+  Cutflow m_cutflow;
+  TH1 *m_cutflowHists[CHANNEL_COUNT + 1] = {};
+
+  // Read path accounting: events each reconstruction container was retrieved
+  // for and the bytes read by all files before the first event
+  unsigned long long m_retrievals[RECO_CONTAINER_COUNT] = {};
+  long long m_bytesReadAtStart = 0;
+
+  /* Transient containers of the current event, reset by execute() */
+  EventArena m_arena;
 };
 
 #endif
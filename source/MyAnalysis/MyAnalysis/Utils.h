@@ -1,20 +1,27 @@
 #ifndef MyAnalysis_Utils_H
 #define MyAnalysis_Utils_H
 
-#include "xAODEgamma/ElectronContainer.h"
-#include "xAODTau/TauJetContainer.h"
-#include "xAODTracking/TrackParticle.h"
-#include "xAODTracking/Vertex.h"
-#include <TVector3.h>
+#include <MyAnalysis/Vector.h>
+#include <string>
 
-TVector3 getParallelComponent(const TVector3 &vec1, const TVector3 &vec2);
-TVector3 getPerpendicularComponent(const TVector3 &vec1, const TVector3 &vec2);
+template <typename T>
+constexpr Vec3<T> getParallelComponent(const Vec3<T> &vec1,
+                                       const Vec3<T> &vec2) {
+  return vec1.dot(vec2) / vec2.mag2() * vec2;
+}
 
-TVector3 calculateImpactParameter(const TVector3 &trackVtx,
-                                  const TVector3 &trackDirection,
-                                  const TVector3 &primaryVertex);
-TVector3 calculateTrackImpactParameter(const xAOD::TrackParticle *track,
-                                       const TVector3 &primaryVertex);
+template <typename T>
+constexpr Vec3<T> getPerpendicularComponent(const Vec3<T> &vec1,
+                                            const Vec3<T> &vec2) {
+  return vec1 - getParallelComponent(vec1, vec2);
+}
+
+template <typename T>
+constexpr Vec3<T> calculateImpactParameter(const Vec3<T> &trackVtx,
+                                           const Vec3<T> &trackDirection,
+                                           const Vec3<T> &primaryVertex) {
+  return getPerpendicularComponent(trackVtx - primaryVertex, trackDirection);
+}
 
 enum TauDecayMode {
   LEPTONIC,
@@ -28,13 +35,55 @@ enum TauDecayMode {
 TauDecayMode inferTauDecayMode(int leptonCount, int pionChargedCount,
                                int pionZeroCount, int neutrinoCount);
 
-TVector3 GetVertexVector(const xAOD::Vertex *vertex);
+/* Decay channel of the tau pair an event was reconstructed in */
+enum DecayChannel : unsigned char {
+  CHANNEL_NONE,
+  CHANNEL_1P0N_1P0N,
+  CHANNEL_1P0N_1P1N,
+  CHANNEL_1P0N_1PXN,
+  CHANNEL_1P1N_1P1N,
+  CHANNEL_1P1N_1PXN,
+  CHANNEL_LEPT_1P0N,
+  CHANNEL_LEPT_1P1N,
+  CHANNEL_LEPT_1PXN,
+  CHANNEL_COUNT
+};
+
+/* Name used in the branch names, e.g. "1p0n_1p1n" */
+const char *decayChannelName(DecayChannel channel);
+
+/**
+ * Parses a comma-separated list of channel names, e.g. "1p0n_1p0n,lept_1p0n",
+ * into per-channel flags. Returns false for an unknown name.
+ */
+bool parseChannelList(const std::string &list, bool selected[CHANNEL_COUNT]);
+
+/* y = (E_pm - E_0) / (E_pm + E_0) */
+template <typename T> constexpr T upsilon(T chargedEnergy, T neutralEnergy) {
+  return (chargedEnergy - neutralEnergy) / (chargedEnergy + neutralEnergy);
+}
+
+// Everything below needs the xAOD EDM. The plain-CMake kernel build defines
+// MYANALYSIS_KERNELS_ONLY and only gets the pure math above.
+#ifndef MYANALYSIS_KERNELS_ONLY
+
+#include "xAODTracking/TrackParticle.h"
+#include "xAODTracking/Vertex.h"
+#include "xAODTruth/TruthParticle.h"
+
+Vec3D calculateTrackImpactParameter(const xAOD::TrackParticle *track,
+                                    const Vec3D &primaryVertex);
+
+Vec3D GetVertexVector(const xAOD::Vertex *vertex);
+
+/* The production vertex, -99 in every component if the particle has none */
+Vec3D GetProductionVertexVector(const xAOD::TruthParticle *particle);
 
-const xAOD::TauJet *GetLeadingJet(const xAOD::TauJetContainer *jets,
-                                  bool positive);
-const xAOD::Electron *
-GetLeadingElectron(const xAOD::ElectronContainer *electrons, bool positive);
+/* Four-momentum of an xAOD object as a kernel vector */
+template <typename Particle> Vec4D GetP4(const Particle *particle) {
+  return Vec4D::from(particle->p4());
+}
 
-double upsilon(double chargedEnergy, double neutralEnergy);
+#endif // MYANALYSIS_KERNELS_ONLY
 
 #endif
\ No newline at end of file
@@ -0,0 +1,152 @@
+#ifndef MyAnalysis_Vector_H
+#define MyAnalysis_Vector_H
+
+#include <cmath>
+#include <type_traits>
+
+/**
+ * Lightweight 3-vector for the observable kernels.
+ *
+ * Unlike TVector3 this is a trivially copyable aggregate, so it can be passed
+ * in registers and all operations inline. The arithmetic follows the operation
+ * order of TVector3, so results match the ROOT classes exactly.
+ */
+template <typename T> struct Vec3 {
+  T x, y, z;
+
+  /* Converts from anything with X(), Y() and Z(), e.g. TVector3 */
+  template <typename V> static constexpr Vec3 from(const V &vec) {
+    return {T(vec.X()), T(vec.Y()), T(vec.Z())};
+  }
+
+  /* Converts to a ROOT-style vector constructible from (x, y, z) */
+  template <typename V> constexpr V to() const { return V(x, y, z); }
+
+  constexpr T dot(const Vec3 &other) const {
+    return x * other.x + y * other.y + z * other.z;
+  }
+
+  constexpr Vec3 cross(const Vec3 &other) const {
+    return {y * other.z - other.y * z, z * other.x - other.z * x,
+            x * other.y - other.x * y};
+  }
+
+  constexpr T mag2() const { return dot(*this); }
+  T mag() const { return std::sqrt(mag2()); }
+
+  Vec3 unit() const {
+    // Both sides of the selects below are evaluated unconditionally, which
+    // lets loops over unit() and boost() be if-converted and vectorised
+    T tot2 = mag2();
+    T inverse = T(1) / std::sqrt(tot2);
+    T tot = tot2 > 0 ? inverse : T(1);
+    return {x * tot, y * tot, z * tot};
+  }
+
+  constexpr Vec3 operator-() const { return {-x, -y, -z}; }
+
+  constexpr Vec3 &operator+=(const Vec3 &other) {
+    x += other.x;
+    y += other.y;
+    z += other.z;
+    return *this;
+  }
+};
+
+template <typename T>
+constexpr Vec3<T> operator+(const Vec3<T> &a, const Vec3<T> &b) {
+  return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+
+template <typename T>
+constexpr Vec3<T> operator-(const Vec3<T> &a, const Vec3<T> &b) {
+  return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+template <typename T> constexpr Vec3<T> operator*(T a, const Vec3<T> &v) {
+  return {a * v.x, a * v.y, a * v.z};
+}
+
+/**
+ * Lightweight Lorentz vector (px, py, pz, E) for the observable kernels.
+ *
+ * The boost follows TLorentzVector::Boost term by term.
+ */
+template <typename T> struct Vec4 {
+  T x, y, z, t;
+
+  /* Converts from anything with Px(), Py(), Pz() and E(), e.g. the p4() of
+   * xAOD objects (TLorentzVector) or a ROOT::Math::LorentzVector */
+  template <typename V> static constexpr Vec4 from(const V &p4) {
+    return {T(p4.Px()), T(p4.Py()), T(p4.Pz()), T(p4.E())};
+  }
+
+  /* Builds a Lorentz vector from a 3-vector and a time component */
+  static constexpr Vec4 from(const Vec3<T> &vec, T time) {
+    return {vec.x, vec.y, vec.z, time};
+  }
+
+  /* Converts to a ROOT-style vector constructible from (x, y, z, t) */
+  template <typename V> constexpr V to() const { return V(x, y, z, t); }
+
+  constexpr T E() const { return t; }
+  constexpr Vec3<T> vect() const { return {x, y, z}; }
+
+  /* Minkowski product with metric (+, -, -, -), as TLorentzVector::Dot */
+  constexpr T dot(const Vec4 &other) const {
+    return t * other.t - x * other.x - y * other.y - z * other.z;
+  }
+
+  constexpr Vec3<T> boostVector() const { return {x / t, y / t, z / t}; }
+
+  /* Boosts by the velocity (bx, by, bz) in place */
+  Vec4 &boost(const Vec3<T> &b) {
+    T b2 = b.x * b.x + b.y * b.y + b.z * b.z;
+    T gamma = T(1) / std::sqrt(T(1) - b2);
+    T bp = b.x * x + b.y * y + b.z * z;
+    T gamma2Unchecked = (gamma - T(1)) / b2;
+    T gamma2 = b2 > 0 ? gamma2Unchecked : T(0);
+
+    x = x + gamma2 * bp * b.x + gamma * b.x * t;
+    y = y + gamma2 * bp * b.y + gamma * b.y * t;
+    z = z + gamma2 * bp * b.z + gamma * b.z * t;
+    t = gamma * (t + bp);
+    return *this;
+  }
+
+  /* Returns a copy boosted into the rest frame of the given four-vector */
+  Vec4 boostedInto(const Vec4 &frame) const {
+    return Vec4(*this).boost(-frame.boostVector());
+  }
+
+  constexpr Vec4 &operator+=(const Vec4 &other) {
+    x += other.x;
+    y += other.y;
+    z += other.z;
+    t += other.t;
+    return *this;
+  }
+};
+
+template <typename T>
+constexpr Vec4<T> operator+(const Vec4<T> &a, const Vec4<T> &b) {
+  return {a.x + b.x, a.y + b.y, a.z + b.z, a.t + b.t};
+}
+
+template <typename T>
+constexpr Vec4<T> operator-(const Vec4<T> &a, const Vec4<T> &b) {
+  return {a.x - b.x, a.y - b.y, a.z - b.z, a.t - b.t};
+}
+
+template <typename T> constexpr Vec4<T> operator*(T a, const Vec4<T> &v) {
+  return {a * v.x, a * v.y, a * v.z, a * v.t};
+}
+
+using Vec3D = Vec3<double>;
+using Vec4D = Vec4<double>;
+
+static_assert(std::is_trivially_copyable<Vec3D>::value &&
+                  std::is_trivially_copyable<Vec4D>::value,
+              "Kernel vectors must stay trivially copyable");
+
+#endif
@@ -0,0 +1,161 @@
+#include <MyAnalysis/BootstrapReplicas.h>
+#include <cmath>
+
+#ifndef MYANALYSIS_KERNELS_ONLY
+#include <TH2D.h>
+#endif
+
+namespace {
+
+/* Poisson(1) CDF at 0..9, scaled to 32 bits */
+const std::uint32_t POISSON_CDF[] = {
+    1580030169u, 3160060337u, 3950075422u, 4213413783u, 4279248374u,
+    4292415292u, 4294609778u, 4294923276u, 4294962463u, 4294966817u};
+
+/* SplitMix64 output function of the counter, keyed by the seed */
+inline std::uint64_t counterHash(std::uint64_t key, std::uint64_t counter) {
+  std::uint64_t z = key + (counter + 1) * 0x9E3779B97F4A7C15ull;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+/* 32-bit integer hash (lowbias32), cheap enough to vectorise */
+inline std::uint32_t hash32(std::uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x7FEB352Du;
+  x ^= x >> 15;
+  x *= 0x846CA68Bu;
+  x ^= x >> 16;
+  return x;
+}
+
+} // namespace
+
+BootstrapReplicas::BootstrapReplicas(std::size_t nReplicas)
+    : m_nReplicas(nReplicas), m_sums(SUM_COUNT * nReplicas, 0.0) {}
+
+void BootstrapReplicas::eventWeights(std::uint64_t eventNumber,
+                                     std::uint64_t seed, std::size_t nReplicas,
+                                     float *weights) {
+  // The event key is mixed once, each replica then only needs a 32-bit hash
+  std::uint64_t key = counterHash(seed, eventNumber);
+  std::uint32_t keyLow = key;
+  std::uint32_t keyHigh = key >> 32;
+
+#pragma omp simd
+  for (std::size_t i = 0; i < nReplicas; ++i) {
+    // Inverse CDF by counting the thresholds below the uniform number
+    std::uint32_t u = hash32(hash32(keyLow ^ std::uint32_t(i)) + keyHigh);
+    int k = 0;
+    for (std::uint32_t threshold : POISSON_CDF) {
+      k += u >= threshold;
+    }
+    weights[i] = k;
+  }
+}
+
+void BootstrapReplicas::add(double phi, const float *weights) {
+  const double cosPhi = std::cos(phi);
+  const double sinPhi = std::sin(phi);
+  double *__restrict sumW = &m_sums[SUM_W * m_nReplicas];
+  double *__restrict sumWCos = &m_sums[SUM_WCOS * m_nReplicas];
+  double *__restrict sumWSin = &m_sums[SUM_WSIN * m_nReplicas];
+
+#pragma omp simd
+  for (std::size_t i = 0; i < m_nReplicas; ++i) {
+    sumW[i] += weights[i];
+    sumWCos[i] += weights[i] * cosPhi;
+    sumWSin[i] += weights[i] * sinPhi;
+  }
+}
+
+void BootstrapReplicas::merge(const BootstrapReplicas &other) {
+  if (m_sums.empty()) {
+    *this = other;
+    return;
+  }
+  for (std::size_t i = 0; i < m_sums.size() && i < other.m_sums.size(); ++i) {
+    m_sums[i] += other.m_sums[i];
+  }
+}
+
+void BootstrapReplicas::estimate(std::size_t replica, double &amplitude,
+                                 double &phase) const {
+  amplitude = 0.0;
+  phase = 0.0;
+  double w = sum(SUM_W, replica);
+  if (w <= 0.0) {
+    return;
+  }
+
+  // Same closed form as FourierMoments: a = A cos(C), b = A sin(C)
+  double a = 2 * sum(SUM_WCOS, replica) / w;
+  double b = -2 * sum(SUM_WSIN, replica) / w;
+  amplitude = std::hypot(a, b);
+  phase = std::atan2(b, a);
+  if (phase < 0.0) {
+    phase += 2 * M_PI;
+  }
+}
+
+void BootstrapReplicas::spread(double &amplitudeError,
+                               double &phaseError) const {
+  amplitudeError = 0.0;
+  phaseError = 0.0;
+  if (m_nReplicas < 2) {
+    return;
+  }
+
+  std::vector<double> amplitudes(m_nReplicas);
+  std::vector<double> phases(m_nReplicas);
+  double meanAmplitude = 0.0;
+  double meanCos = 0.0;
+  double meanSin = 0.0;
+  for (std::size_t i = 0; i < m_nReplicas; ++i) {
+    estimate(i, amplitudes[i], phases[i]);
+    meanAmplitude += amplitudes[i] / m_nReplicas;
+    meanCos += std::cos(phases[i]);
+    meanSin += std::sin(phases[i]);
+  }
+  double meanPhase = std::atan2(meanSin, meanCos);
+
+  double varAmplitude = 0.0;
+  double varPhase = 0.0;
+  for (std::size_t i = 0; i < m_nReplicas; ++i) {
+    double dAmplitude = amplitudes[i] - meanAmplitude;
+    double dPhase = std::remainder(phases[i] - meanPhase, 2 * M_PI);
+    varAmplitude += dAmplitude * dAmplitude;
+    varPhase += dPhase * dPhase;
+  }
+  amplitudeError = std::sqrt(varAmplitude / (m_nReplicas - 1));
+  phaseError = std::sqrt(varPhase / (m_nReplicas - 1));
+}
+
+#ifndef MYANALYSIS_KERNELS_ONLY
+
+TH2D BootstrapReplicas::makeHistogram(const char *name) const {
+  return TH2D(name, name, m_nReplicas, 0.0, m_nReplicas, SUM_COUNT, 0.0,
+              SUM_COUNT);
+}
+
+void BootstrapReplicas::store(TH1 &hist) const {
+  for (std::size_t i = 0; i < m_nReplicas; ++i) {
+    for (int s = 0; s < SUM_COUNT; ++s) {
+      hist.SetBinContent(i + 1, s + 1, m_sums[s * m_nReplicas + i]);
+    }
+  }
+}
+
+BootstrapReplicas BootstrapReplicas::load(const TH1 &hist) {
+  BootstrapReplicas replicas(hist.GetNbinsX());
+  for (std::size_t i = 0; i < replicas.m_nReplicas; ++i) {
+    for (int s = 0; s < SUM_COUNT; ++s) {
+      replicas.m_sums[s * replicas.m_nReplicas + i] =
+          hist.GetBinContent(i + 1, s + 1);
+    }
+  }
+  return replicas;
+}
+
+#endif // MYANALYSIS_KERNELS_ONLY
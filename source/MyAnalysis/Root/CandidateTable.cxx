@@ -0,0 +1,78 @@
+#include "xAODTracking/TrackParticlexAODHelpers.h"
+#include <MyAnalysis/CandidateTable.h>
+#include <MyAnalysis/ObjectSelector.h>
+#include <MyAnalysis/Utils.h>
+#include <TruthUtils/AtlasPID.h>
+
+void CandidateTable::fill(const TauPairEvent &event,
+                          const TruthDecayIndex &truthDecays) {
+  ChargedCandidates<xAOD::TauJet> jets;
+  if (event.tauJets != nullptr) {
+    jets = SelectCandidates<TauJetSelection>(event.tauJets);
+  }
+
+  for (bool positive : {true, false}) {
+    const int row = candidateRow(positive);
+    const TauDecay &tau =
+        positive ? truthDecays.tauPos() : truthDecays.tauNeg();
+
+    if (tau.decayMode == LEPTONIC) {
+      // Leading lepton with the flavour of the truth lepton
+      RecoLepton lepton;
+      if (std::abs(tau.lepton().particle->pdgId()) == MUON) {
+        lepton = SelectLeadingLepton<MuonSelection>(event.muons, positive);
+        kind[row] = CANDIDATE_MUON;
+      } else {
+        lepton =
+            SelectLeadingLepton<ElectronSelection>(event.electrons, positive);
+        kind[row] = CANDIDATE_ELECTRON;
+      }
+      object[row] = lepton.particle;
+      track[row] = lepton.track;
+    } else {
+      const xAOD::TauJet *jet = jets.leading(positive);
+      kind[row] = CANDIDATE_TAU_JET;
+      object[row] = jet;
+      tauJet[row] = jet;
+      if (jet != nullptr) {
+        track[row] = jet->track(0)->track();
+        if (jet->vertex() != nullptr) {
+          hasVertex[row] = true;
+          vertex[row] = GetVertexVector(jet->vertex());
+        }
+      }
+    }
+
+    if (object[row] == nullptr) {
+      kind[row] = CANDIDATE_NONE;
+      continue;
+    }
+    p4[row] = GetP4(object[row]);
+    trackP4[row] = GetP4(track[row]);
+  }
+}
+
+void CandidateTable::fillD0Significance(int row,
+                                        const xAOD::EventInfo *eventInfo) {
+  d0Significance[row] = xAOD::TrackingHelpers::d0significance(
+      track[row], eventInfo->beamPosSigmaX(), eventInfo->beamPosSigmaY(),
+      eventInfo->beamPosSigmaXY());
+}
+
+void CandidateTable::fillRhoSums(int row) {
+  const xAOD::TauJet *jet = tauJet[row];
+
+  Vec4D charged{0.0, 0.0, 0.0, 0.0};
+  for (auto jetTrack : jet->tracks()) {
+    charged += GetP4(jetTrack->track());
+  }
+
+  Vec4D neutral{0.0, 0.0, 0.0, 0.0};
+  for (size_t i = 0; i < jet->nNeutralPFOs(); ++i) {
+    neutral += GetP4(jet->neutralPFO(i));
+  }
+
+  chargedP4[row] = charged;
+  neutralP4[row] = neutral;
+  rhoUpsilon[row] = upsilon(charged.E(), neutral.E());
+}
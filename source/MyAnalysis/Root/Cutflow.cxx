@@ -0,0 +1,106 @@
+#include <MyAnalysis/Cutflow.h>
+#include <cstdio>
+
+#ifndef MYANALYSIS_KERNELS_ONLY
+#include <TH1.h>
+#endif
+
+namespace {
+
+const char *const CUT_NAMES[CUT_COUNT] = {
+    "higgs",   "tauPair",     "channel", "primaryVertex",
+    "tauJets", "tauVertices", "lepton"};
+
+} // namespace
+
+const char *cutName(Cut cut) { return CUT_NAMES[cut]; }
+
+void Cutflow::merge(const Cutflow &other) {
+  for (int channel = 0; channel < CHANNEL_COUNT; channel++) {
+    for (int exit = 0; exit <= CUT_COUNT; exit++) {
+      m_exits[channel][exit] += other.m_exits[channel][exit];
+    }
+  }
+}
+
+unsigned long long Cutflow::exits(DecayChannel channel, int exit) const {
+  if (channel != CHANNEL_COUNT) {
+    return m_exits[channel][exit];
+  }
+  unsigned long long events = 0;
+  for (int ch = 0; ch < CHANNEL_COUNT; ch++) {
+    events += m_exits[ch][exit];
+  }
+  return events;
+}
+
+unsigned long long Cutflow::events(DecayChannel channel) const {
+  return passedIndex(channel, -1);
+}
+
+unsigned long long Cutflow::passed(DecayChannel channel, Cut cut) const {
+  return passedIndex(channel, cut);
+}
+
+unsigned long long Cutflow::passedIndex(DecayChannel channel,
+                                        int cut) const {
+  // Events that failed a later cut, or none, passed this one
+  unsigned long long events = 0;
+  for (int exit = cut + 1; exit <= CUT_COUNT; exit++) {
+    events += exits(channel, exit);
+  }
+  return events;
+}
+
+#ifndef MYANALYSIS_KERNELS_ONLY
+
+TH1D Cutflow::makeHistogram(const char *name) {
+  TH1D hist(name, name, CUT_COUNT + 1, 0.0, CUT_COUNT + 1);
+  hist.GetXaxis()->SetBinLabel(1, "all");
+  for (int cut = 0; cut < CUT_COUNT; cut++) {
+    hist.GetXaxis()->SetBinLabel(cut + 2, CUT_NAMES[cut]);
+  }
+  return hist;
+}
+
+void Cutflow::store(DecayChannel channel, TH1 &hist) const {
+  hist.SetBinContent(1, events(channel));
+  for (int cut = 0; cut < CUT_COUNT; cut++) {
+    hist.SetBinContent(cut + 2, passed(channel, static_cast<Cut>(cut)));
+  }
+}
+
+#endif // MYANALYSIS_KERNELS_ONLY
+
+void Cutflow::appendTable(DecayChannel channel, std::string &table) const {
+  const unsigned long long all = events(channel);
+  char line[128];
+  std::snprintf(line, sizeof(line), "%s:\n  %-16s %12llu\n",
+                channel == CHANNEL_COUNT ? "all channels"
+                                         : decayChannelName(channel),
+                "all", all);
+  table += line;
+
+  unsigned long long previous = all;
+  for (int cut = 0; cut < CUT_COUNT; cut++) {
+    const unsigned long long events = passedIndex(channel, cut);
+    std::snprintf(line, sizeof(line), "  %-16s %12llu %7.2f%% %7.2f%%\n",
+                  CUT_NAMES[cut], events,
+                  previous > 0 ? 100.0 * events / previous : 0.0,
+                  all > 0 ? 100.0 * events / all : 0.0);
+    table += line;
+    previous = events;
+  }
+}
+
+std::string Cutflow::table() const {
+  std::string table;
+  appendTable(CHANNEL_COUNT, table);
+  // Channel none only has events failing the truth cuts, the total shows them
+  for (int channel = CHANNEL_NONE + 1; channel < CHANNEL_COUNT; channel++) {
+    if (events(static_cast<DecayChannel>(channel)) > 0) {
+      appendTable(static_cast<DecayChannel>(channel), table);
+    }
+  }
+  return table;
+}
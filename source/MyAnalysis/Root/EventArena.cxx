@@ -0,0 +1,102 @@
+#include <MyAnalysis/EventArena.h>
+#include <algorithm>
+#include <cstdio>
+#include <new>
+
+/* Header of a heap allocation, linking the blocks of the current event */
+struct EventArena::HeapBlock {
+  HeapBlock *next;
+  void *memory;
+  std::size_t alignment;
+};
+
+void ArenaStats::merge(const ArenaStats &other) {
+  events += other.events;
+  allocations += other.allocations;
+  bytes += other.bytes;
+  heapAllocations += other.heapAllocations;
+  heapBytes += other.heapBytes;
+  heapEvents += other.heapEvents;
+  peakBytes = std::max(peakBytes, other.peakBytes);
+}
+
+std::string ArenaStats::summary() const {
+  char line[256];
+  std::snprintf(line, sizeof(line),
+                "%llu events, %llu allocations of %llu bytes, at most %zu "
+                "bytes per event, %llu heap allocations of %llu bytes in "
+                "%llu events",
+                events, allocations, bytes, peakBytes, heapAllocations,
+                heapBytes, heapEvents);
+  return line;
+}
+
+EventArena::EventArena(std::size_t capacity)
+    : m_buffer(std::make_unique<std::byte[]>(capacity)),
+      m_capacity(capacity) {}
+
+EventArena::~EventArena() { releaseHeapBlocks(); }
+
+void EventArena::reset() {
+  flushStats();
+
+  // Grow to fit the event that overflowed, with room to spare
+  if (m_heapBlocks != nullptr) {
+    m_capacity = std::max(2 * m_capacity, m_used + 2 * m_heapBytes);
+    m_buffer = std::make_unique<std::byte[]>(m_capacity);
+    releaseHeapBlocks();
+  }
+
+  m_used = 0;
+  m_stats.events++;
+  m_pendingStats = true;
+}
+
+void EventArena::flushStats() {
+  if (!m_pendingStats) {
+    return;
+  }
+  m_stats.peakBytes = std::max(m_stats.peakBytes, m_used + m_heapBytes);
+  if (m_heapBlocks != nullptr) {
+    m_stats.heapEvents++;
+  }
+  m_pendingStats = false;
+}
+
+void *EventArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+  m_stats.allocations++;
+  m_stats.bytes += bytes;
+
+  void *pointer = m_buffer.get() + m_used;
+  std::size_t space = m_capacity - m_used;
+  if (std::align(alignment, bytes, pointer, space) != nullptr) {
+    m_used = m_capacity - space + bytes;
+    return pointer;
+  }
+
+  m_stats.heapAllocations++;
+  m_stats.heapBytes += bytes;
+  m_heapBytes += bytes;
+  void *memory = ::operator new(bytes, std::align_val_t(alignment));
+  m_heapBlocks = new HeapBlock{m_heapBlocks, memory, alignment};
+  return memory;
+}
+
+void EventArena::do_deallocate(void *, std::size_t, std::size_t) {
+  // Freed all at once by reset()
+}
+
+bool EventArena::do_is_equal(const std::pmr::memory_resource &other) const
+    noexcept {
+  return this == &other;
+}
+
+void EventArena::releaseHeapBlocks() {
+  while (m_heapBlocks != nullptr) {
+    HeapBlock *block = m_heapBlocks;
+    m_heapBlocks = block->next;
+    ::operator delete(block->memory, std::align_val_t(block->alignment));
+    delete block;
+  }
+  m_heapBytes = 0;
+}
@@ -0,0 +1,104 @@
+#include <MyAnalysis/EventIndex.h>
+#include <MyAnalysis/TauPairProcessor.h>
+#include <TDirectory.h>
+#include <TFile.h>
+#include <TTree.h>
+#include <filesystem>
+#include <memory>
+
+namespace {
+
+const char *const TREE_NAME = "event_index";
+
+} // namespace
+
+std::string EventIndex::sidecarPath(const std::string &inputPath,
+                                    const std::string &directory) {
+  if (directory.empty()) {
+    return inputPath + ".eventindex.root";
+  }
+  std::filesystem::path input(inputPath);
+  std::filesystem::path sidecar = std::filesystem::path(directory) /
+                                  input.parent_path().filename() /
+                                  input.filename();
+  return sidecar.string() + ".eventindex.root";
+}
+
+void EventIndex::clear() {
+  m_tauNegModes.clear();
+  m_tauPosModes.clear();
+}
+
+void EventIndex::add(TauDecayMode tauNeg, TauDecayMode tauPos) {
+  m_tauNegModes.push_back(tauNeg);
+  m_tauPosModes.push_back(tauPos);
+}
+
+DecayChannel EventIndex::channel(std::size_t entry) const {
+  return decayChannelOf(static_cast<TauDecayMode>(m_tauNegModes[entry]),
+                        static_cast<TauDecayMode>(m_tauPosModes[entry]));
+}
+
+bool EventIndex::write(const std::string &path) const {
+  TDirectory::TContext context;
+  std::unique_ptr<TFile> file(TFile::Open(path.c_str(), "RECREATE"));
+  if (!file || file->IsZombie()) {
+    return false;
+  }
+
+  // Owned by the file, which deletes it on Close()
+  TTree *tree = new TTree(TREE_NAME, "truth decay modes of the input entries");
+  unsigned char tauNegMode, tauPosMode;
+  tree->Branch("tau_neg_mode", &tauNegMode);
+  tree->Branch("tau_pos_mode", &tauPosMode);
+  for (std::size_t entry = 0; entry < size(); entry++) {
+    tauNegMode = m_tauNegModes[entry];
+    tauPosMode = m_tauPosModes[entry];
+    tree->Fill();
+  }
+
+  bool written = file->Write() > 0;
+  file->Close();
+  return written;
+}
+
+bool EventIndex::read(const std::string &path) {
+  clear();
+
+  TDirectory::TContext context;
+  std::unique_ptr<TFile> file(TFile::Open(path.c_str()));
+  if (!file || file->IsZombie()) {
+    return false;
+  }
+  TTree *tree = file->Get<TTree>(TREE_NAME);
+  if (tree == nullptr) {
+    return false;
+  }
+
+  unsigned char tauNegMode, tauPosMode;
+  tree->SetBranchAddress("tau_neg_mode", &tauNegMode);
+  tree->SetBranchAddress("tau_pos_mode", &tauPosMode);
+  const long long entries = tree->GetEntries();
+  m_tauNegModes.reserve(entries);
+  m_tauPosModes.reserve(entries);
+  for (long long entry = 0; entry < entries; entry++) {
+    if (tree->GetEntry(entry) <= 0) {
+      clear();
+      return false;
+    }
+    m_tauNegModes.push_back(tauNegMode);
+    m_tauPosModes.push_back(tauPosMode);
+  }
+  return true;
+}
+
+std::vector<long long>
+EventIndex::entryList(const bool selected[CHANNEL_COUNT]) const {
+  std::vector<long long> entries;
+  for (std::size_t entry = 0; entry < size(); entry++) {
+    if (selected[channel(entry)]) {
+      entries.push_back(entry);
+    }
+  }
+  return entries;
+}
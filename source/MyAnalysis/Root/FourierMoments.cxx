@@ -0,0 +1,119 @@
+#include <MyAnalysis/FourierMoments.h>
+#include <cmath>
+
+#ifndef MYANALYSIS_KERNELS_ONLY
+#include <TAxis.h>
+#include <TH1D.h>
+#endif
+
+void FourierMoments::add(double phi, double weight) {
+  double cosPhi = std::cos(phi);
+  double sinPhi = std::sin(phi);
+  double weight2 = weight * weight;
+
+  m_sums[SUM_W] += weight;
+  m_sums[SUM_WCOS] += weight * cosPhi;
+  m_sums[SUM_WSIN] += weight * sinPhi;
+  m_sums[SUM_W2] += weight2;
+  m_sums[SUM_W2COS] += weight2 * cosPhi;
+  m_sums[SUM_W2SIN] += weight2 * sinPhi;
+  m_sums[SUM_W2COS2] += weight2 * cosPhi * cosPhi;
+  m_sums[SUM_W2SIN2] += weight2 * sinPhi * sinPhi;
+  m_sums[SUM_W2COSSIN] += weight2 * cosPhi * sinPhi;
+}
+
+void FourierMoments::merge(const FourierMoments &other) {
+  for (int i = 0; i < SUM_COUNT; i++) {
+    m_sums[i] += other.m_sums[i];
+  }
+}
+
+FourierMomentResult FourierMoments::result() const {
+  FourierMomentResult result;
+  double w = m_sums[SUM_W];
+  result.sumWeights = w;
+  if (w <= 0.0) {
+    return result;
+  }
+
+  double meanCos = m_sums[SUM_WCOS] / w;
+  double meanSin = m_sums[SUM_WSIN] / w;
+
+  // Covariance of the weighted means from the spread of the events
+  double varCos = (m_sums[SUM_W2COS2] - 2 * meanCos * m_sums[SUM_W2COS] +
+                   meanCos * meanCos * m_sums[SUM_W2]) /
+                  (w * w);
+  double varSin = (m_sums[SUM_W2SIN2] - 2 * meanSin * m_sums[SUM_W2SIN] +
+                   meanSin * meanSin * m_sums[SUM_W2]) /
+                  (w * w);
+  double covCosSin =
+      (m_sums[SUM_W2COSSIN] - meanSin * m_sums[SUM_W2COS] -
+       meanCos * m_sums[SUM_W2SIN] + meanCos * meanSin * m_sums[SUM_W2]) /
+      (w * w);
+
+  // a = A cos(C) and b = A sin(C)
+  double a = 2 * meanCos;
+  double b = -2 * meanSin;
+  double varA = 4 * varCos;
+  double varB = 4 * varSin;
+  double covAB = -4 * covCosSin;
+
+  double amplitude = std::hypot(a, b);
+  result.amplitude = amplitude;
+  result.phase = std::atan2(b, a);
+  if (result.phase < 0.0) {
+    result.phase += 2 * M_PI;
+  }
+  if (amplitude == 0.0) {
+    return result;
+  }
+
+  // Linear propagation to A = hypot(a, b) and C = atan2(b, a)
+  double dAda = a / amplitude;
+  double dAdb = b / amplitude;
+  double dCda = -b / (amplitude * amplitude);
+  double dCdb = a / (amplitude * amplitude);
+
+  result.amplitudeVariance =
+      dAda * dAda * varA + 2 * dAda * dAdb * covAB + dAdb * dAdb * varB;
+  result.phaseVariance =
+      dCda * dCda * varA + 2 * dCda * dCdb * covAB + dCdb * dCdb * varB;
+  result.amplitudePhaseCovariance = dAda * dCda * varA +
+                                    (dAda * dCdb + dAdb * dCda) * covAB +
+                                    dAdb * dCdb * varB;
+  return result;
+}
+
+#ifndef MYANALYSIS_KERNELS_ONLY
+
+namespace {
+
+const char *const SUM_LABELS[] = {
+    "w", "w cos", "w sin", "w^2", "w^2 cos", "w^2 sin",
+    "w^2 cos^2", "w^2 sin^2", "w^2 cos sin"};
+
+} // namespace
+
+TH1D FourierMoments::makeHistogram(const char *name) {
+  TH1D hist(name, name, SUM_COUNT, 0.0, SUM_COUNT);
+  for (int i = 0; i < SUM_COUNT; i++) {
+    hist.GetXaxis()->SetBinLabel(i + 1, SUM_LABELS[i]);
+  }
+  return hist;
+}
+
+void FourierMoments::store(TH1 &hist) const {
+  for (int i = 0; i < SUM_COUNT; i++) {
+    hist.SetBinContent(i + 1, m_sums[i]);
+  }
+}
+
+FourierMoments FourierMoments::load(const TH1 &hist) {
+  FourierMoments moments;
+  for (int i = 0; i < SUM_COUNT; i++) {
+    moments.m_sums[i] = hist.GetBinContent(i + 1);
+  }
+  return moments;
+}
+
+#endif // MYANALYSIS_KERNELS_ONLY
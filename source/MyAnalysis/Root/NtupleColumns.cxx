@@ -0,0 +1,31 @@
+#include <MyAnalysis/NtupleColumns.h>
+#include <MyAnalysis/Utils.h>
+
+ROOT::RDF::RNode defineWideColumns(ROOT::RDataFrame &frame) {
+  ROOT::RDF::RNode node = frame;
+  if (!frame.HasColumn("channel")) {
+    return node;
+  }
+
+  for (int channel = CHANNEL_NONE + 1; channel < CHANNEL_COUNT; channel++) {
+    for (const char *kind : {"truth", "recon"}) {
+      std::string column =
+          std::string("phiCP_") +
+          decayChannelName(static_cast<DecayChannel>(channel)) + "_" + kind;
+      std::string expression = "channel == " + std::to_string(channel) +
+                               " ? double(phiCP_" + kind + ") : -99.0";
+      node = node.Define(column, expression);
+    }
+  }
+  return node;
+}
+
+bool isCompactColumn(const std::string &column) {
+  return column == "channel" || column == "phiCP_truth" ||
+         column == "phiCP_recon";
+}
+
+ROOT::RDF::RNode defineDouble(ROOT::RDF::RNode node, const std::string &name,
+                              const std::string &column) {
+  return node.Define(name, "double(" + column + ")");
+}
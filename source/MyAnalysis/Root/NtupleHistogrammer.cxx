@@ -0,0 +1,146 @@
+#include <MyAnalysis/NtupleColumns.h>
+#include <MyAnalysis/NtupleHistogrammer.h>
+#include <ROOT/RDFHelpers.hxx>
+#include <ROOT/RDataFrame.hxx>
+#include <TH1F.h>
+#include <TH2F.h>
+#include <cmath>
+#include <set>
+
+NtupleHistogrammer::NtupleHistogrammer(const std::string &name)
+    : m_name(name) {}
+
+NtupleHistogrammer::~NtupleHistogrammer() = default;
+
+void NtupleHistogrammer::addSample(const std::string &sample,
+                                   const std::string &path) {
+  m_samples.emplace_back(sample, path);
+}
+
+void NtupleHistogrammer::addCut(const std::string &branch, double lower,
+                                double upper) {
+  m_cuts.push_back({branch, lower, upper});
+}
+
+void NtupleHistogrammer::addHistogram(const std::string &histName,
+                                      const std::string &branch, int bins,
+                                      double lower, double upper) {
+  m_requests.push_back({histName, branch, "", bins, lower, upper, 0, 0, 0});
+}
+
+void NtupleHistogrammer::addHistogram2D(
+    const std::string &histName, const std::string &xBranch,
+    const std::string &yBranch, int xBins, double xLower, double xUpper,
+    int yBins, double yLower, double yUpper) {
+  m_requests.push_back({histName, xBranch, yBranch, xBins, xLower, xUpper,
+                        yBins, yLower, yUpper});
+}
+
+void NtupleHistogrammer::run() {
+  std::vector<ROOT::RDF::RResultHandle> handles;
+  std::vector<std::pair<std::string, ROOT::RDF::RResultPtr<TH1F>>> hists;
+  std::vector<std::pair<std::string, ROOT::RDF::RResultPtr<TH2F>>> hists2D;
+  std::vector<std::string> sampleOfHist;
+  std::vector<std::string> sampleOfHist2D;
+
+  for (const auto &[sample, path] : m_samples) {
+    ROOT::RDataFrame frame(m_name, path);
+    ROOT::RDF::RNode node = defineWideColumns(frame);
+    for (std::size_t i = 0; i < m_cuts.size(); i++) {
+      const Cut &cut = m_cuts[i];
+      std::string column = "cutValue" + std::to_string(i);
+      node = defineDouble(node, column, cut.branch)
+                 .Filter(
+                     [cut](double value) {
+                       value = std::abs(value);
+                       return (cut.lower == 0 || value >= cut.lower) &&
+                              (cut.upper == 0 || value <= cut.upper);
+                     },
+                     {column});
+    }
+
+    for (const Request &request : m_requests) {
+      const char *name = request.histName.c_str();
+      if (request.yBranch.empty()) {
+        auto hist = node.Fill(TH1F(name, name, request.xBins, request.xLower,
+                                   request.xUpper),
+                              {request.xBranch});
+        handles.emplace_back(hist);
+        hists.emplace_back(request.histName, hist);
+        sampleOfHist.push_back(sample);
+      } else {
+        auto hist = node.Fill(
+            TH2F(name, name, request.xBins, request.xLower, request.xUpper,
+                 request.yBins, request.yLower, request.yUpper),
+            {request.xBranch, request.yBranch});
+        handles.emplace_back(hist);
+        hists2D.emplace_back(request.histName, hist);
+        sampleOfHist2D.push_back(sample);
+      }
+    }
+  }
+
+  // One event loop for all samples, sharing the implicit MT thread pool
+  ROOT::RDF::RunGraphs(handles);
+
+  // Keep detached copies, the results die with the data frames
+  m_hists.clear();
+  for (std::size_t i = 0; i < hists.size(); i++) {
+    TH1 *hist = static_cast<TH1 *>(hists[i].second->Clone());
+    hist->SetDirectory(nullptr);
+    m_hists[sampleOfHist[i]][hists[i].first].reset(hist);
+  }
+  for (std::size_t i = 0; i < hists2D.size(); i++) {
+    TH1 *hist = static_cast<TH1 *>(hists2D[i].second->Clone());
+    hist->SetDirectory(nullptr);
+    m_hists[sampleOfHist2D[i]][hists2D[i].first].reset(hist);
+  }
+}
+
+TH1 *NtupleHistogrammer::histogram(const std::string &sample,
+                                   const std::string &histName) const {
+  auto hists = m_hists.find(sample);
+  if (hists == m_hists.end()) {
+    return nullptr;
+  }
+  auto hist = hists->second.find(histName);
+  return hist == hists->second.end() ? nullptr : hist->second.get();
+}
+
+std::vector<std::string>
+NtupleHistogrammer::branchesInRange(double lower, double upper) const {
+  std::vector<ROOT::RDF::RResultHandle> handles;
+  std::vector<std::pair<std::string, ROOT::RDF::RResultPtr<ULong64_t>>>
+      counts;
+
+  for (const auto &[sample, path] : m_samples) {
+    ROOT::RDataFrame frame(m_name, path);
+    ROOT::RDF::RNode node = defineWideColumns(frame);
+
+    for (const std::string &column : node.GetColumnNames()) {
+      // The compact phiCP pair is only reachable through the wide names
+      if (isCompactColumn(column)) {
+        continue;
+      }
+      auto count = defineDouble(node, "rangeValue", column)
+                       .Filter(
+                           [lower, upper](double value) {
+                             return value >= lower && value <= upper;
+                           },
+                           {"rangeValue"})
+                       .Count();
+      handles.emplace_back(count);
+      counts.emplace_back(column, count);
+    }
+  }
+
+  ROOT::RDF::RunGraphs(handles);
+
+  std::set<std::string> branches;
+  for (auto &[column, count] : counts) {
+    if (*count > 0) {
+      branches.insert(column);
+    }
+  }
+  return {branches.begin(), branches.end()};
+}
@@ -1,117 +1,482 @@
 #include "MyAnalysis/Observables.h"
 #include "MyAnalysis/Utils.h"
-#include <TLorentzVector.h>
-#include <TVector3.h>
+#include <MyAnalysis/Vector.h>
+#include <algorithm>
+#include <cmath>
 
-/* IP-method */
-double phiCP_ImpactParameter(TVector3 pionPosImpactParam,
-                             TVector3 pionNegImpactParam,
-                             TLorentzVector pionPosP4, TLorentzVector pionNegP4,
-                             TLorentzVector referenceFrame) {
-  TLorentzVector pionPosImpactParamP4(pionPosImpactParam.Unit(), 0.0);
-  TLorentzVector pionNegImpactParamP4(pionNegImpactParam.Unit(), 0.0);
+namespace {
 
+/*
+ * Everything a kernel needs to finish the angle: the cosine between the two
+ * planes, the orientation triple product and whether the result has to be
+ * shifted by pi. Splitting the acos off keeps the arithmetic part of the
+ * kernels free of library calls, so the batch loops can vectorise it.
+ */
+template <typename T> struct PlaneAngle {
+  T cosPhi;
+  T angleO;
+  bool shiftByPi;
+};
+
+template <typename T> inline T resolve(const PlaneAngle<T> &planes) {
+  const T pi = T(M_PI);
+  T phi = std::acos(planes.cosPhi);
+  phi = planes.angleO >= 0 ? phi : 2 * pi - phi;
+  if (planes.shiftByPi) {
+    return phi < pi ? phi + pi : phi - pi;
+  }
+  return phi;
+}
+
+/* IP-method */
+template <typename T>
+[[gnu::always_inline]] inline PlaneAngle<T>
+impactParameterKernel(const Vec3<T> &pionPosImpactParam,
+                      const Vec3<T> &pionNegImpactParam, Vec4<T> pionPosP4,
+                      Vec4<T> pionNegP4, const Vec4<T> &referenceFrame) {
   // Boost into reference frame
-  TVector3 boostVector = referenceFrame.BoostVector();
-  pionPosImpactParamP4.Boost(-boostVector);
-  pionNegImpactParamP4.Boost(-boostVector);
-  pionPosP4.Boost(-boostVector);
-  pionNegP4.Boost(-boostVector);
+  Vec4<T> pionPosImpactParamP4 = Vec4<T>::from(pionPosImpactParam.unit(), T(0))
+                                     .boostedInto(referenceFrame);
+  Vec4<T> pionNegImpactParamP4 = Vec4<T>::from(pionNegImpactParam.unit(), T(0))
+                                     .boostedInto(referenceFrame);
+  pionPosP4 = pionPosP4.boostedInto(referenceFrame);
+  pionNegP4 = pionNegP4.boostedInto(referenceFrame);
 
   // Get the impact parameter component perpendicular to the momentum
-  TVector3 planePos =
-      getPerpendicularComponent(pionPosImpactParamP4.Vect(), pionPosP4.Vect())
-          .Unit();
-  TVector3 planeNeg =
-      getPerpendicularComponent(pionNegImpactParamP4.Vect(), pionNegP4.Vect())
-          .Unit();
+  Vec3<T> planePos =
+      getPerpendicularComponent(pionPosImpactParamP4.vect(), pionPosP4.vect())
+          .unit();
+  Vec3<T> planeNeg =
+      getPerpendicularComponent(pionNegImpactParamP4.vect(), pionNegP4.vect())
+          .unit();
 
-  double angleO = pionNegP4.Vect().Unit().Dot(planePos.Cross(planeNeg));
-  double phi = acos(planePos * planeNeg);
+  T angleO = pionNegP4.vect().unit().dot(planePos.cross(planeNeg));
 
-  return angleO >= 0 ? phi : 2 * M_PI - phi;
+  return {planePos.dot(planeNeg), angleO, false};
 }
 
 /* ρ-method */
-double phiCP_Pion_RhoDecayPlane(TLorentzVector pionPosP4,
-                                TLorentzVector pionNeuPosP4,
-                                TLorentzVector pionNegP4,
-                                TLorentzVector pionNeuNegP4,
-                                TLorentzVector referenceFrame) {
+template <typename T>
+[[gnu::always_inline]] inline PlaneAngle<T>
+rhoDecayPlaneKernel(Vec4<T> pionPosP4, Vec4<T> pionNeuPosP4, Vec4<T> pionNegP4,
+                    Vec4<T> pionNeuNegP4, const Vec4<T> &referenceFrame) {
   // Calculate y+ and y- in the laboratory frame
-  double yPos = upsilon(pionPosP4.E(), pionNeuPosP4.E());
-  double yNeg = upsilon(pionNegP4.E(), pionNeuNegP4.E());
+  T yPos = upsilon(pionPosP4.E(), pionNeuPosP4.E());
+  T yNeg = upsilon(pionNegP4.E(), pionNeuNegP4.E());
 
   // Boost into reference frame
-  TVector3 boostVector = referenceFrame.BoostVector();
-  pionPosP4.Boost(-boostVector);
-  pionNeuPosP4.Boost(-boostVector);
-  pionNegP4.Boost(-boostVector);
-  pionNeuNegP4.Boost(-boostVector);
+  pionPosP4 = pionPosP4.boostedInto(referenceFrame);
+  pionNeuPosP4 = pionNeuPosP4.boostedInto(referenceFrame);
+  pionNegP4 = pionNegP4.boostedInto(referenceFrame);
+  pionNeuNegP4 = pionNeuNegP4.boostedInto(referenceFrame);
 
   // Get the neutral p4 component perpendicular to the momentum
-  TVector3 planePos =
-      getPerpendicularComponent(pionNeuPosP4.Vect(), pionPosP4.Vect()).Unit();
-  TVector3 planeNeg =
-      getPerpendicularComponent(pionNeuNegP4.Vect(), pionNegP4.Vect()).Unit();
+  Vec3<T> planePos =
+      getPerpendicularComponent(pionNeuPosP4.vect(), pionPosP4.vect()).unit();
+  Vec3<T> planeNeg =
+      getPerpendicularComponent(pionNeuNegP4.vect(), pionNegP4.vect()).unit();
 
-  double angleO = pionNegP4.Vect().Unit().Dot(planePos.Cross(planeNeg));
-  double phiStar = acos(planePos * planeNeg);
+  T angleO = pionNegP4.vect().unit().dot(planePos.cross(planeNeg));
 
-  double phiStarPrime = angleO >= 0 ? phiStar : 2 * M_PI - phiStar;
+  return {planePos.dot(planeNeg), angleO, yPos * yNeg < 0};
+}
 
-  if (yPos * yNeg < 0) {
-    if (phiStarPrime < M_PI) {
-      return phiStarPrime + M_PI;
-    } else {
-      return phiStarPrime - M_PI;
-    }
+/* IP-ρ-method */
+template <typename T>
+[[gnu::always_inline]] inline PlaneAngle<T>
+ipRhoKernel(const Vec3<T> &pionImpactParam, Vec4<T> pionP4,
+            Vec4<T> rhoChargedP4, Vec4<T> rhoNeutralP4,
+            const Vec4<T> &referenceFrame, bool rhoIsPositive) {
+  // Calculate y in the laboratory frame
+  T y = upsilon(rhoChargedP4.E(), rhoNeutralP4.E());
+
+  // Boost into reference frame
+  Vec4<T> pionImpactParamP4 =
+      Vec4<T>::from(pionImpactParam.unit(), T(0)).boostedInto(referenceFrame);
+  pionP4 = pionP4.boostedInto(referenceFrame);
+  rhoChargedP4 = rhoChargedP4.boostedInto(referenceFrame);
+  rhoNeutralP4 = rhoNeutralP4.boostedInto(referenceFrame);
+
+  Vec3<T> planeIP =
+      getPerpendicularComponent(pionImpactParamP4.vect(), pionP4.vect()).unit();
+  Vec3<T> planeRho =
+      getPerpendicularComponent(rhoNeutralP4.vect(), rhoChargedP4.vect())
+          .unit();
+
+  T angleO = rhoIsPositive
+                 ? pionP4.vect().unit().dot(planeRho.cross(planeIP))
+                 : rhoChargedP4.vect().unit().dot(planeIP.cross(planeRho));
+
+  return {planeRho.dot(planeIP), angleO, y < 0};
+}
+
+/*
+ * The invariant kernels finish with an atan2 instead: the cosine and the
+ * signed sine of the angle, both scaled by the same positive factor.
+ */
+template <typename T> struct InvariantAngle {
+  T cosPhi;
+  T sinPhi;
+  bool shiftByPi;
+};
+
+template <typename T> inline T resolve(const InvariantAngle<T> &planes) {
+  const T pi = T(M_PI);
+  T phi = std::atan2(planes.sinPhi, planes.cosPhi);
+  phi = phi >= 0 ? phi : phi + 2 * pi;
+  if (planes.shiftByPi) {
+    return phi < pi ? phi + pi : phi - pi;
   }
+  return phi;
+}
 
-  return phiStarPrime;
+/* The part of a Minkowski-orthogonal to b */
+template <typename T>
+[[gnu::always_inline]] inline Vec4<T> orthogonalPart(const Vec4<T> &a,
+                                                     const Vec4<T> &b) {
+  return a - a.dot(b) / b.dot(b) * b;
 }
 
-/* IP-ρ-method */
-double phiCP_IP_Rho(TVector3 pionImpactParam, TLorentzVector pionP4,
-                    TLorentzVector rhoChargedP4, TLorentzVector rhoNeutralP4,
-                    TLorentzVector referenceFrame, bool rhoIsPositive) {
-  TLorentzVector pionImpactParamP4(pionImpactParam.Unit(), 0.0);
+/*
+ * The part of a orthogonal to the frame and to the momentum. In the rest
+ * frame of the reference frame it is (0, a_perp), with a_perp the component
+ * of a perpendicular to the momentum, the plane vector of the boosted
+ * kernels up to its length.
+ */
+template <typename T>
+[[gnu::always_inline]] inline Vec4<T>
+planeVector(const Vec4<T> &a, const Vec4<T> &momentum, const Vec4<T> &frame) {
+  return orthogonalPart(orthogonalPart(a, frame),
+                        orthogonalPart(momentum, frame));
+}
 
-  // Calculate y in the laboratory frame
-  double y = (rhoChargedP4.E() - rhoNeutralP4.E()) /
-             (rhoChargedP4.E() + rhoNeutralP4.E());
+/*
+ * Angle between the plane vectors a and b, orientated by the triple product
+ * axis . (a x b) in the rest frame of the reference frame.
+ *
+ * The orientation comes from the covariant vector w_mu = eps_{mu nu rho
+ * sigma} frame^nu a^rho b^sigma (eps_{0123} = 1): in the rest frame it is
+ * (0, -m (a x b)), with m the frame mass, so axis . (a x b) has the sign of
+ * -(axis^mu w_mu).
+ *
+ * The magnitude uses the half-angle form phi = 2 atan2(|d|, |s|), with d and
+ * s the difference and sum of a and b scaled to the same length. Taking it
+ * from |a x b| = sqrt(-w.w) / m instead loses the precision of a boosted
+ * frame in the cancellation of w.w, by up to a few 1e-9 rad at small angles.
+ */
+template <typename T>
+[[gnu::always_inline]] inline InvariantAngle<T>
+invariantPlaneAngle(const Vec4<T> &a, const Vec4<T> &b, const Vec4<T> &axis,
+                    const Vec4<T> &frame, bool shiftByPi) {
+  // 2x2 minors of a and b over the components (t, x, y, z)
+  T m01 = a.t * b.x - a.x * b.t;
+  T m02 = a.t * b.y - a.y * b.t;
+  T m03 = a.t * b.z - a.z * b.t;
+  T m12 = a.x * b.y - a.y * b.x;
+  T m13 = a.x * b.z - a.z * b.x;
+  T m23 = a.y * b.z - a.z * b.y;
 
-  // Boost into reference frame
-  TVector3 cmfBoostVector = referenceFrame.BoostVector();
-  pionImpactParamP4.Boost(-cmfBoostVector);
-  pionP4.Boost(-cmfBoostVector);
-  rhoChargedP4.Boost(-cmfBoostVector);
-  rhoNeutralP4.Boost(-cmfBoostVector);
-
-  TVector3 planeIP =
-      getPerpendicularComponent(pionImpactParamP4.Vect(), pionP4.Vect()).Unit();
-  TVector3 planeRho =
-      getPerpendicularComponent(rhoNeutralP4.Vect(), rhoChargedP4.Vect())
-          .Unit();
-
-  double angleO;
+  T w0 = frame.x * m23 - frame.y * m13 + frame.z * m12;
+  T w1 = -(frame.t * m23 - frame.y * m03 + frame.z * m02);
+  T w2 = frame.t * m13 - frame.x * m03 + frame.z * m01;
+  T w3 = -(frame.t * m12 - frame.x * m02 + frame.y * m01);
+  T orientation = -(axis.t * w0 + axis.x * w1 + axis.y * w2 + axis.z * w3);
+
+  // The plane vectors are space-like, -v.v is their length squared in the
+  // rest frame. With |d| = 2 sin(phi/2) and |s| = 2 cos(phi/2) for unit
+  // planes, sin(phi) and cos(phi) are proportional to 2|d||s| and s^2 - d^2.
+  T lengthA = std::sqrt(std::max(-a.dot(a), T(0)));
+  T lengthB = std::sqrt(std::max(-b.dot(b), T(0)));
+  Vec4<T> difference = lengthB * a - lengthA * b;
+  Vec4<T> sum = lengthB * a + lengthA * b;
+  T difference2 = std::max(-difference.dot(difference), T(0));
+  T sum2 = std::max(-sum.dot(sum), T(0));
+  T cross = 2 * std::sqrt(difference2 * sum2);
+
+  // A plane of zero length leaves both at zero, return pi/2 like the boosted
+  // kernels, whose product of the zero unit vector is 0
+  if (difference2 == 0 && sum2 == 0) {
+    return {T(0), T(1), shiftByPi};
+  }
+  return {sum2 - difference2, orientation >= 0 ? cross : -cross, shiftByPi};
+}
+
+/* IP-method without boosts */
+template <typename T>
+[[gnu::always_inline]] inline InvariantAngle<T> impactParameterInvariantKernel(
+    const Vec3<T> &pionPosImpactParam, const Vec3<T> &pionNegImpactParam,
+    const Vec4<T> &pionPosP4, const Vec4<T> &pionNegP4,
+    const Vec4<T> &referenceFrame) {
+  Vec4<T> planePos = planeVector(Vec4<T>::from(pionPosImpactParam, T(0)),
+                                 pionPosP4, referenceFrame);
+  Vec4<T> planeNeg = planeVector(Vec4<T>::from(pionNegImpactParam, T(0)),
+                                 pionNegP4, referenceFrame);
+  return invariantPlaneAngle(planePos, planeNeg, pionNegP4, referenceFrame,
+                             false);
+}
+
+/* ρ-method without boosts */
+template <typename T>
+[[gnu::always_inline]] inline InvariantAngle<T> rhoDecayPlaneInvariantKernel(
+    const Vec4<T> &pionPosP4, const Vec4<T> &pionNeuPosP4,
+    const Vec4<T> &pionNegP4, const Vec4<T> &pionNeuNegP4,
+    const Vec4<T> &referenceFrame) {
+  T yPos = upsilon(pionPosP4.E(), pionNeuPosP4.E());
+  T yNeg = upsilon(pionNegP4.E(), pionNeuNegP4.E());
+
+  Vec4<T> planePos = planeVector(pionNeuPosP4, pionPosP4, referenceFrame);
+  Vec4<T> planeNeg = planeVector(pionNeuNegP4, pionNegP4, referenceFrame);
+  return invariantPlaneAngle(planePos, planeNeg, pionNegP4, referenceFrame,
+                             yPos * yNeg < 0);
+}
+
+/* IP-ρ-method without boosts */
+template <typename T>
+[[gnu::always_inline]] inline InvariantAngle<T>
+ipRhoInvariantKernel(const Vec3<T> &pionImpactParam, const Vec4<T> &pionP4,
+                     const Vec4<T> &rhoChargedP4, const Vec4<T> &rhoNeutralP4,
+                     const Vec4<T> &referenceFrame, bool rhoIsPositive) {
+  T y = upsilon(rhoChargedP4.E(), rhoNeutralP4.E());
+
+  Vec4<T> planeIP = planeVector(Vec4<T>::from(pionImpactParam, T(0)), pionP4,
+                                referenceFrame);
+  Vec4<T> planeRho = planeVector(rhoNeutralP4, rhoChargedP4, referenceFrame);
+
+  // The boosted kernel orientates by pion . (rho x IP) for a positive rho and
+  // by rhoCharged . (IP x rho) otherwise
   if (rhoIsPositive) {
-    angleO = pionP4.Vect().Unit().Dot(planeRho.Cross(planeIP));
+    return invariantPlaneAngle(planeRho, planeIP, pionP4, referenceFrame,
+                               y < 0);
+  }
+  return invariantPlaneAngle(planeIP, planeRho, rhoChargedP4, referenceFrame,
+                             y < 0);
+}
+
+/* The kernel of the method */
+template <PhiCPMethod Method, typename T>
+[[gnu::always_inline]] inline auto
+impactParameterPlanes(const Vec3<T> &pionPosImpactParam,
+                      const Vec3<T> &pionNegImpactParam,
+                      const Vec4<T> &pionPosP4, const Vec4<T> &pionNegP4,
+                      const Vec4<T> &referenceFrame) {
+  if constexpr (Method == PHICP_INVARIANT) {
+    return impactParameterInvariantKernel(pionPosImpactParam,
+                                          pionNegImpactParam, pionPosP4,
+                                          pionNegP4, referenceFrame);
+  } else {
+    return impactParameterKernel(pionPosImpactParam, pionNegImpactParam,
+                                 pionPosP4, pionNegP4, referenceFrame);
+  }
+}
+
+template <PhiCPMethod Method, typename T>
+[[gnu::always_inline]] inline auto
+rhoDecayPlanePlanes(const Vec4<T> &pionPosP4, const Vec4<T> &pionNeuPosP4,
+                    const Vec4<T> &pionNegP4, const Vec4<T> &pionNeuNegP4,
+                    const Vec4<T> &referenceFrame) {
+  if constexpr (Method == PHICP_INVARIANT) {
+    return rhoDecayPlaneInvariantKernel(pionPosP4, pionNeuPosP4, pionNegP4,
+                                        pionNeuNegP4, referenceFrame);
   } else {
-    angleO = rhoChargedP4.Vect().Unit().Dot(planeIP.Cross(planeRho));
+    return rhoDecayPlaneKernel(pionPosP4, pionNeuPosP4, pionNegP4,
+                               pionNeuNegP4, referenceFrame);
   }
+}
+
+template <PhiCPMethod Method, typename T>
+[[gnu::always_inline]] inline auto
+ipRhoPlanes(const Vec3<T> &pionImpactParam, const Vec4<T> &pionP4,
+            const Vec4<T> &rhoChargedP4, const Vec4<T> &rhoNeutralP4,
+            const Vec4<T> &referenceFrame, bool rhoIsPositive) {
+  if constexpr (Method == PHICP_INVARIANT) {
+    return ipRhoInvariantKernel(pionImpactParam, pionP4, rhoChargedP4,
+                                rhoNeutralP4, referenceFrame, rhoIsPositive);
+  } else {
+    return ipRhoKernel(pionImpactParam, pionP4, rhoChargedP4, rhoNeutralP4,
+                       referenceFrame, rhoIsPositive);
+  }
+}
+
+inline Vec3D load(const ThreeVectorArrays &a, std::size_t i) {
+  return {a.x[i], a.y[i], a.z[i]};
+}
+
+inline Vec4D load(const FourMomentumArrays &a, std::size_t i) {
+  return {a.px[i], a.py[i], a.pz[i], a.e[i]};
+}
 
-  double phiStar = acos(planeRho * planeIP);
+/*
+ * Runs a kernel over all events in chunks: the arithmetic part of a chunk is
+ * evaluated in a SIMD loop, the acos and the branches afterwards.
+ */
+template <typename Kernel>
+inline void runBatch(std::size_t nEvents, double *phiCP, Kernel kernel) {
+  constexpr std::size_t chunkSize = 64;
+  decltype(kernel(std::size_t(0))) planes[chunkSize];
 
-  double phiStarPrime = angleO >= 0 ? phiStar : 2 * M_PI - phiStar;
+  for (std::size_t begin = 0; begin < nEvents; begin += chunkSize) {
+    std::size_t n = std::min(chunkSize, nEvents - begin);
 
-  if (y < 0) {
-    if (phiStarPrime < M_PI) {
-      return phiStarPrime + M_PI;
-    } else {
-      return phiStarPrime - M_PI;
+#pragma omp simd
+    for (std::size_t i = 0; i < n; ++i) {
+      planes[i] = kernel(begin + i);
+    }
+
+    for (std::size_t i = 0; i < n; ++i) {
+      phiCP[begin + i] = resolve(planes[i]);
     }
   }
+}
+
+} // namespace
 
-  return phiStarPrime;
-}
\ No newline at end of file
+template <typename T, PhiCPMethod Method>
+T phiCP_ImpactParameter(const Vec3<T> &pionPosImpactParam,
+                        const Vec3<T> &pionNegImpactParam,
+                        const Vec4<T> &pionPosP4, const Vec4<T> &pionNegP4,
+                        const Vec4<T> &referenceFrame) {
+  return resolve(impactParameterPlanes<Method>(
+      pionPosImpactParam, pionNegImpactParam, pionPosP4, pionNegP4,
+      referenceFrame));
+}
+
+template <typename T, PhiCPMethod Method>
+T phiCP_Pion_RhoDecayPlane(const Vec4<T> &pionPosP4,
+                           const Vec4<T> &pionNeuPosP4,
+                           const Vec4<T> &pionNegP4,
+                           const Vec4<T> &pionNeuNegP4,
+                           const Vec4<T> &referenceFrame) {
+  return resolve(rhoDecayPlanePlanes<Method>(
+      pionPosP4, pionNeuPosP4, pionNegP4, pionNeuNegP4, referenceFrame));
+}
+
+template <typename T, PhiCPMethod Method>
+T phiCP_IP_Rho(const Vec3<T> &pionImpactParam, const Vec4<T> &pionP4,
+               const Vec4<T> &rhoChargedP4, const Vec4<T> &rhoNeutralP4,
+               const Vec4<T> &referenceFrame, bool rhoIsPositive) {
+  return resolve(ipRhoPlanes<Method>(pionImpactParam, pionP4, rhoChargedP4,
+                                     rhoNeutralP4, referenceFrame,
+                                     rhoIsPositive));
+}
+
+template float phiCP_ImpactParameter<float, PHICP_BOOSTED>(
+    const Vec3<float> &, const Vec3<float> &, const Vec4<float> &,
+    const Vec4<float> &, const Vec4<float> &);
+template double phiCP_ImpactParameter<double, PHICP_BOOSTED>(
+    const Vec3D &, const Vec3D &, const Vec4D &, const Vec4D &, const Vec4D &);
+template float phiCP_Pion_RhoDecayPlane<float, PHICP_BOOSTED>(
+    const Vec4<float> &, const Vec4<float> &, const Vec4<float> &,
+    const Vec4<float> &, const Vec4<float> &);
+template double phiCP_Pion_RhoDecayPlane<double, PHICP_BOOSTED>(
+    const Vec4D &, const Vec4D &, const Vec4D &, const Vec4D &, const Vec4D &);
+template float phiCP_IP_Rho<float, PHICP_BOOSTED>(
+    const Vec3<float> &, const Vec4<float> &, const Vec4<float> &,
+    const Vec4<float> &, const Vec4<float> &, bool);
+template double phiCP_IP_Rho<double, PHICP_BOOSTED>(
+    const Vec3D &, const Vec4D &, const Vec4D &, const Vec4D &, const Vec4D &,
+    bool);
+template float phiCP_ImpactParameter<float, PHICP_INVARIANT>(
+    const Vec3<float> &, const Vec3<float> &, const Vec4<float> &,
+    const Vec4<float> &, const Vec4<float> &);
+template double phiCP_ImpactParameter<double, PHICP_INVARIANT>(
+    const Vec3D &, const Vec3D &, const Vec4D &, const Vec4D &, const Vec4D &);
+template float phiCP_Pion_RhoDecayPlane<float, PHICP_INVARIANT>(
+    const Vec4<float> &, const Vec4<float> &, const Vec4<float> &,
+    const Vec4<float> &, const Vec4<float> &);
+template double phiCP_Pion_RhoDecayPlane<double, PHICP_INVARIANT>(
+    const Vec4D &, const Vec4D &, const Vec4D &, const Vec4D &, const Vec4D &);
+template float phiCP_IP_Rho<float, PHICP_INVARIANT>(
+    const Vec3<float> &, const Vec4<float> &, const Vec4<float> &,
+    const Vec4<float> &, const Vec4<float> &, bool);
+template double phiCP_IP_Rho<double, PHICP_INVARIANT>(
+    const Vec3D &, const Vec4D &, const Vec4D &, const Vec4D &, const Vec4D &,
+    bool);
+
+#ifndef MYANALYSIS_KERNELS_ONLY
+
+#include <TLorentzVector.h>
+#include <TVector3.h>
+
+/* IP-method */
+double phiCP_ImpactParameter(TVector3 pionPosImpactParam,
+                             TVector3 pionNegImpactParam,
+                             TLorentzVector pionPosP4, TLorentzVector pionNegP4,
+                             TLorentzVector referenceFrame) {
+  return phiCP_ImpactParameter(
+      Vec3D::from(pionPosImpactParam), Vec3D::from(pionNegImpactParam),
+      Vec4D::from(pionPosP4), Vec4D::from(pionNegP4),
+      Vec4D::from(referenceFrame));
+}
+
+/* ρ-method */
+double phiCP_Pion_RhoDecayPlane(TLorentzVector pionPosP4,
+                                TLorentzVector pionNeuPosP4,
+                                TLorentzVector pionNegP4,
+                                TLorentzVector pionNeuNegP4,
+                                TLorentzVector referenceFrame) {
+  return phiCP_Pion_RhoDecayPlane(
+      Vec4D::from(pionPosP4), Vec4D::from(pionNeuPosP4),
+      Vec4D::from(pionNegP4), Vec4D::from(pionNeuNegP4),
+      Vec4D::from(referenceFrame));
+}
+
+/* IP-ρ-method */
+double phiCP_IP_Rho(TVector3 pionImpactParam, TLorentzVector pionP4,
+                    TLorentzVector rhoChargedP4, TLorentzVector rhoNeutralP4,
+                    TLorentzVector referenceFrame, bool rhoIsPositive) {
+  return phiCP_IP_Rho(Vec3D::from(pionImpactParam), Vec4D::from(pionP4),
+                      Vec4D::from(rhoChargedP4), Vec4D::from(rhoNeutralP4),
+                      Vec4D::from(referenceFrame), rhoIsPositive);
+}
+
+#endif // MYANALYSIS_KERNELS_ONLY
+
+void phiCP_ImpactParameter_Batch(std::size_t nEvents,
+                                 ThreeVectorArrays pionPosImpactParam,
+                                 ThreeVectorArrays pionNegImpactParam,
+                                 FourMomentumArrays pionPosP4,
+                                 FourMomentumArrays pionNegP4,
+                                 FourMomentumArrays referenceFrame,
+                                 double *phiCP) {
+  runBatch(nEvents, phiCP, [&](std::size_t i) {
+    return impactParameterPlanes<DEFAULT_PHICP_METHOD>(
+        load(pionPosImpactParam, i), load(pionNegImpactParam, i),
+        load(pionPosP4, i), load(pionNegP4, i), load(referenceFrame, i));
+  });
+}
+
+void phiCP_Pion_RhoDecayPlane_Batch(std::size_t nEvents,
+                                    FourMomentumArrays pionPosP4,
+                                    FourMomentumArrays pionNeuPosP4,
+                                    FourMomentumArrays pionNegP4,
+                                    FourMomentumArrays pionNeuNegP4,
+                                    FourMomentumArrays referenceFrame,
+                                    double *phiCP) {
+  runBatch(nEvents, phiCP, [&](std::size_t i) {
+    return rhoDecayPlanePlanes<DEFAULT_PHICP_METHOD>(
+        load(pionPosP4, i), load(pionNeuPosP4, i), load(pionNegP4, i),
+        load(pionNeuNegP4, i), load(referenceFrame, i));
+  });
+}
+
+void phiCP_IP_Rho_Batch(std::size_t nEvents, ThreeVectorArrays pionImpactParam,
+                        FourMomentumArrays pionP4,
+                        FourMomentumArrays rhoChargedP4,
+                        FourMomentumArrays rhoNeutralP4,
+                        FourMomentumArrays referenceFrame, bool rhoIsPositive,
+                        double *phiCP) {
+  // Branch outside of the loop, so that the kernel sees a constant orientation
+  if (rhoIsPositive) {
+    runBatch(nEvents, phiCP, [&](std::size_t i) {
+      return ipRhoPlanes<DEFAULT_PHICP_METHOD>(
+          load(pionImpactParam, i), load(pionP4, i), load(rhoChargedP4, i),
+          load(rhoNeutralP4, i), load(referenceFrame, i), true);
+    });
+  } else {
+    runBatch(nEvents, phiCP, [&](std::size_t i) {
+      return ipRhoPlanes<DEFAULT_PHICP_METHOD>(
+          load(pionImpactParam, i), load(pionP4, i), load(rhoChargedP4, i),
+          load(rhoNeutralP4, i), load(referenceFrame, i), false);
+    });
+  }
+}
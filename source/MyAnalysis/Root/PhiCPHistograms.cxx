@@ -0,0 +1,91 @@
+#include <MyAnalysis/PhiCPHistograms.h>
+#include <TH1.h>
+#include <cmath>
+
+namespace {
+
+const int TRUTH = 0;
+const int RECON = 1;
+
+const char *const VARIANT_SUFFIXES[] = {"", "_d0sig", "_yy"};
+
+bool isSet(double value) { return value != -99.0; }
+
+} // namespace
+
+std::string PhiCPHistograms::name(DecayChannel channel, bool truth,
+                                  Variant variant) {
+  return std::string("phiCP_") + decayChannelName(channel) +
+         (truth ? "_truth" : "_recon") + VARIANT_SUFFIXES[variant];
+}
+
+bool PhiCPHistograms::book(
+    const Cuts &cuts,
+    const std::function<TH1 *(const TH1F &)> &registerHist) {
+  m_cuts = cuts;
+
+  for (int channel = CHANNEL_NONE + 1; channel < CHANNEL_COUNT; channel++) {
+    for (int kind : {TRUTH, RECON}) {
+      for (int variant = 0; variant < VARIANT_COUNT; variant++) {
+        std::string histName = name(static_cast<DecayChannel>(channel),
+                                    kind == TRUTH,
+                                    static_cast<Variant>(variant));
+        TH1 *hist = registerHist(TH1F(histName.c_str(), histName.c_str(),
+                                      BINS, 0.0, 2 * M_PI));
+        if (hist == nullptr) {
+          return false;
+        }
+        m_hists[channel][kind][variant] = hist;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool PhiCPHistograms::passes(const TauAnalysisRecord &record,
+                             Variant variant) const {
+  switch (variant) {
+  case VARIANT_D0SIG: {
+    // Only tracks used with the impact parameter method have a significance
+    const double d0Sigs[] = {record.d0_sig_tau_pos_track,
+                             record.d0_sig_tau_neg_track};
+    bool any = false;
+    for (double d0Sig : d0Sigs) {
+      if (!isSet(d0Sig)) {
+        continue;
+      }
+      if (std::abs(d0Sig) < m_cuts.d0Sig) {
+        return false;
+      }
+      any = true;
+    }
+    return any;
+  }
+  case VARIANT_YY:
+    return isSet(record.yy_tau_tracks) &&
+           std::abs(record.yy_tau_tracks) >= m_cuts.yy;
+  default:
+    return true;
+  }
+}
+
+void PhiCPHistograms::fill(const TauAnalysisRecord &record) const {
+  if (record.channel == CHANNEL_NONE) {
+    return;
+  }
+
+  for (int variant = 0; variant < VARIANT_COUNT; variant++) {
+    if (!passes(record, static_cast<Variant>(variant))) {
+      continue;
+    }
+    TH1 *const *hists = m_hists[record.channel][TRUTH];
+    if (isSet(record.phiCP_truth) && hists[variant] != nullptr) {
+      hists[variant]->Fill(record.phiCP_truth);
+    }
+    hists = m_hists[record.channel][RECON];
+    if (isSet(record.phiCP_recon) && hists[variant] != nullptr) {
+      hists[variant]->Fill(record.phiCP_recon);
+    }
+  }
+}
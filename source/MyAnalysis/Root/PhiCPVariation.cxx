@@ -0,0 +1,94 @@
+#include <MyAnalysis/PhiCPVariation.h>
+
+namespace {
+
+/* The settings a variation name can give, each at most once */
+enum VariationSetting {
+  SETTING_FRAME = 1 << 0,
+  SETTING_ORIGIN = 1 << 1,
+  SETTING_SHIFT = 1 << 2
+};
+
+/*
+ * Applies one setting of a variation name, false if it is unknown or if
+ * given already holds its kind, e.g. a second frame
+ */
+bool applySetting(const std::string &setting, PhiCPVariation &variation,
+                  unsigned &given) {
+  VariationSetting kind;
+  if (setting == "visible") {
+    variation.frame = FRAME_VISIBLE;
+    kind = SETTING_FRAME;
+  } else if (setting == "candidates") {
+    variation.frame = FRAME_CANDIDATES;
+    kind = SETTING_FRAME;
+  } else if (setting == "truthtaus") {
+    variation.frame = FRAME_TRUTH_TAUS;
+    kind = SETTING_FRAME;
+  } else if (setting == "jetvertex") {
+    variation.origin = ORIGIN_JET_VERTEX;
+    kind = SETTING_ORIGIN;
+  } else if (setting == "pv") {
+    variation.origin = ORIGIN_PRIMARY_VERTEX;
+    kind = SETTING_ORIGIN;
+  } else if (setting == "noshift") {
+    variation.leptonicShift = false;
+    kind = SETTING_SHIFT;
+  } else {
+    return false;
+  }
+  if (given & kind) {
+    return false;
+  }
+  given |= kind;
+  return true;
+}
+
+bool sameSettings(const PhiCPVariation &a, const PhiCPVariation &b) {
+  return a.frame == b.frame && a.origin == b.origin &&
+         a.leptonicShift == b.leptonicShift;
+}
+
+} // namespace
+
+bool parseVariationList(const std::string &list,
+                        std::vector<PhiCPVariation> &variations) {
+  variations.clear();
+  if (list.empty()) {
+    return true;
+  }
+
+  std::size_t begin = 0;
+  while (begin <= list.size()) {
+    std::size_t end = list.find(',', begin);
+    if (end == std::string::npos) {
+      end = list.size();
+    }
+
+    PhiCPVariation variation;
+    variation.name = list.substr(begin, end - begin);
+    unsigned given = 0;
+    std::size_t settingBegin = 0;
+    while (settingBegin <= variation.name.size()) {
+      std::size_t settingEnd = variation.name.find('_', settingBegin);
+      if (settingEnd == std::string::npos) {
+        settingEnd = variation.name.size();
+      }
+      if (!applySetting(variation.name.substr(settingBegin,
+                                              settingEnd - settingBegin),
+                        variation, given)) {
+        return false;
+      }
+      settingBegin = settingEnd + 1;
+    }
+
+    for (const PhiCPVariation &previous : variations) {
+      if (sameSettings(previous, variation)) {
+        return false;
+      }
+    }
+    variations.push_back(variation);
+    begin = end + 1;
+  }
+  return variations.size() <= MAX_PHICP_VARIATIONS;
+}
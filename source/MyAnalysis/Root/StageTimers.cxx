@@ -0,0 +1,72 @@
+#include <MyAnalysis/StageTimers.h>
+#include <TH1.h>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+const char *const STAGE_NAMES[STAGE_COUNT] = {
+    "retrieveTruth", "truthDecays",      "retrieveReco", "primaryVertex",
+    "selection",     "impactParameters", "phiCP",        "output"};
+
+// 50 bins per decade from 1 ns to 10 s
+const int BINS_PER_DECADE = 50;
+const int DECADES = 10;
+
+} // namespace
+
+const char *timedStageName(TimedStage stage) { return STAGE_NAMES[stage]; }
+
+std::string StageTimers::name(DecayChannel channel, TimedStage stage) {
+  return std::string("stageTime_") + decayChannelName(channel) + "_" +
+         timedStageName(stage);
+}
+
+bool StageTimers::book(
+    const std::function<TH1 *(const TH1D &)> &registerHist) {
+  std::vector<double> edges(BINS_PER_DECADE * DECADES + 1);
+  for (std::size_t i = 0; i < edges.size(); i++) {
+    edges[i] = std::pow(10.0, static_cast<double>(i) / BINS_PER_DECADE);
+  }
+
+  for (int channel = 0; channel < CHANNEL_COUNT; channel++) {
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+      std::string histName = name(static_cast<DecayChannel>(channel),
+                                  static_cast<TimedStage>(stage));
+      TH1 *hist = registerHist(TH1D(histName.c_str(), ";time [ns];events",
+                                    edges.size() - 1, edges.data()));
+      if (hist == nullptr) {
+        return false;
+      }
+      m_hists[channel][stage] = hist;
+    }
+  }
+
+  return true;
+}
+
+void StageTimers::fill(DecayChannel channel, const StageClock &clock) const {
+  for (int stage = 0; stage < STAGE_COUNT; stage++) {
+    if (clock.lapped(static_cast<TimedStage>(stage))) {
+      m_hists[channel][stage]->Fill(clock.ns(static_cast<TimedStage>(stage)));
+    }
+  }
+}
+
+StageTimers::Summary StageTimers::summary(DecayChannel channel,
+                                          TimedStage stage) const {
+  TH1 *hist = m_hists[channel][stage];
+  Summary summary;
+  summary.events = hist->GetEntries();
+  if (summary.events == 0.0) {
+    return summary;
+  }
+
+  const double probabilities[] = {0.5, 0.99};
+  double quantiles[2];
+  hist->GetQuantiles(2, quantiles, probabilities);
+  summary.mean = hist->GetMean();
+  summary.p50 = quantiles[0];
+  summary.p99 = quantiles[1];
+  return summary;
+}
@@ -0,0 +1,250 @@
+#include <MyAnalysis/TauAnalysisWriter.h>
+#include <RVersion.h>
+#include <ROOT/RNTupleModel.hxx>
+#include <ROOT/RNTupleWriter.hxx>
+#include <TBranch.h>
+#include <TDirectory.h>
+#include <TTree.h>
+#include <algorithm>
+#include <type_traits>
+
+// RNTuple left the Experimental namespace in ROOT 6.36
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 36, 0)
+namespace RNTupleAPI = ROOT;
+#else
+namespace RNTupleAPI = ROOT::Experimental;
+#endif
+
+namespace {
+
+const int TRUTH = 0;
+const int RECON = 1;
+
+/* Wide channels in the original branch order: hadronic, then leptonic */
+const DecayChannel WIDE_CHANNELS[] = {
+    CHANNEL_1P0N_1P0N, CHANNEL_1P0N_1P1N, CHANNEL_1P0N_1PXN,
+    CHANNEL_1P1N_1P1N, CHANNEL_1P1N_1PXN, CHANNEL_LEPT_1P0N,
+    CHANNEL_LEPT_1P1N, CHANNEL_LEPT_1PXN};
+
+std::string phiCPBranchName(DecayChannel channel, int kind) {
+  return std::string("phiCP_") + decayChannelName(channel) +
+         (kind == TRUTH ? "_truth" : "_recon");
+}
+
+} // namespace
+
+struct TauAnalysisWriter::NTupleSink {
+  std::unique_ptr<RNTupleAPI::RNTupleWriter> writer;
+  std::unique_ptr<RNTupleAPI::REntry> entry;
+};
+
+bool parseOutputLayout(const std::string &name, OutputLayout &layout) {
+  if (name == "wide") {
+    layout = LAYOUT_WIDE;
+  } else if (name == "compact") {
+    layout = LAYOUT_COMPACT;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool parseOutputFormat(const std::string &name, OutputFormat &format) {
+  if (name == "ttree") {
+    format = FORMAT_TTREE;
+  } else if (name == "rntuple") {
+    format = FORMAT_RNTUPLE;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+TauAnalysisWriter::TauAnalysisWriter() = default;
+
+TauAnalysisWriter::~TauAnalysisWriter() = default;
+
+void TauAnalysisWriter::setUp(const Options &options) {
+  m_layout = options.layout;
+  m_variations = options.variations;
+  m_variations.resize(
+      std::min<std::size_t>(m_variations.size(), MAX_PHICP_VARIATIONS));
+  m_bufferSize = std::max<std::size_t>(options.bufferSize, 1);
+  m_buffers.assign(std::max<std::size_t>(options.nSlots, 1), {});
+  for (std::vector<TauAnalysisRecord> &buffer : m_buffers) {
+    buffer.reserve(m_bufferSize);
+  }
+}
+
+template <class Visitor>
+void TauAnalysisWriter::visitColumns(Visitor &&visitor) {
+  if (m_layout == LAYOUT_COMPACT) {
+    CompactValues &values = m_compact;
+
+    visitor("channel", &values.channel);
+    visitor("phiCP_truth", &values.phiCP_truth);
+    visitor("phiCP_recon", &values.phiCP_recon);
+    for (std::size_t i = 0; i < m_variations.size(); i++) {
+      visitor("phiCP_recon_" + m_variations[i],
+              &values.phiCP_recon_variations[i]);
+    }
+
+    // For applying cuts
+    visitor("d0_sig_tau_pos_track", &values.d0_sig_tau_pos_track);
+    visitor("d0_sig_tau_neg_track", &values.d0_sig_tau_neg_track);
+    visitor("y_tau_pos_track", &values.y_tau_pos_track);
+    visitor("y_tau_neg_track", &values.y_tau_neg_track);
+    visitor("yy_tau_tracks", &values.yy_tau_tracks);
+
+    // For debugging purposes
+    visitor("tau_jets_vtx_diff", &values.tau_jets_vtx_diff);
+    return;
+  }
+
+  // Hadronic and leptonic observables
+  for (DecayChannel channel : WIDE_CHANNELS) {
+    for (int kind : {TRUTH, RECON}) {
+      visitor(phiCPBranchName(channel, kind), &m_phiCP[channel][kind]);
+    }
+  }
+
+  // Variations of the reconstructed phiCP, in the channel of the event
+  for (std::size_t i = 0; i < m_variations.size(); i++) {
+    visitor("phiCP_recon_" + m_variations[i],
+            &m_record.phiCP_recon_variations[i]);
+  }
+
+  // For applying cuts
+  visitor("d0_sig_tau_pos_track", &m_record.d0_sig_tau_pos_track);
+  visitor("d0_sig_tau_neg_track", &m_record.d0_sig_tau_neg_track);
+  visitor("y_tau_pos_track", &m_record.y_tau_pos_track);
+  visitor("y_tau_neg_track", &m_record.y_tau_neg_track);
+  visitor("yy_tau_tracks", &m_record.yy_tau_tracks);
+
+  // For debugging purposes
+  visitor("tau_jets_vtx_diff", &m_record.tau_jets_vtx_diff);
+}
+
+void TauAnalysisWriter::attach(TTree *tree, const Options &options) {
+  setUp(options);
+  m_tree = tree;
+
+  visitColumns([tree](const std::string &name, auto *address) {
+    tree->Branch(name.c_str(), address);
+  });
+  if (m_layout == LAYOUT_COMPACT) {
+    aliasCompact(tree);
+  }
+
+  if (options.basketSize > 0) {
+    tree->SetBasketSize("*", options.basketSize);
+  }
+  if (options.compression >= 0) {
+    for (TBranch *branch : TRangeDynCast<TBranch>(tree->GetListOfBranches())) {
+      branch->SetCompressionSettings(options.compression);
+    }
+  }
+}
+
+void TauAnalysisWriter::attach(TDirectory *directory, const std::string &name,
+                               const Options &options) {
+  setUp(options);
+
+  auto model = RNTupleAPI::RNTupleModel::Create();
+  visitColumns([&model](const std::string &name, auto *address) {
+    model->MakeField<std::remove_pointer_t<decltype(address)>>(name);
+  });
+
+  RNTupleAPI::RNTupleWriteOptions writeOptions;
+  if (options.compression >= 0) {
+    writeOptions.SetCompression(options.compression);
+  }
+  if (options.pageSize > 0) {
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 34, 0)
+    writeOptions.SetMaxUnzippedPageSize(options.pageSize);
+#else
+    writeOptions.SetApproxUnzippedPageSize(options.pageSize);
+#endif
+  }
+  if (options.clusterSize > 0) {
+    writeOptions.SetApproxZippedClusterSize(options.clusterSize);
+  }
+
+  m_ntuple = std::make_unique<NTupleSink>();
+  m_ntuple->writer = RNTupleAPI::RNTupleWriter::Append(
+      std::move(model), name, *directory, writeOptions);
+
+  // Bind the entry to the same values the tree branches point to
+  m_ntuple->entry = m_ntuple->writer->CreateEntry();
+  visitColumns([this](const std::string &name, auto *address) {
+    m_ntuple->entry->BindRawPtr(name, address);
+  });
+}
+
+void TauAnalysisWriter::aliasCompact(TTree *tree) {
+  // Keep the wide branch names usable in TTree::Draw and friends
+  for (DecayChannel channel : WIDE_CHANNELS) {
+    for (int kind : {TRUTH, RECON}) {
+      std::string formula = "channel == " + std::to_string(channel) + " ? " +
+                            (kind == TRUTH ? "phiCP_truth" : "phiCP_recon") +
+                            " : -99";
+      tree->SetAlias(phiCPBranchName(channel, kind).c_str(), formula.c_str());
+    }
+  }
+}
+
+void TauAnalysisWriter::write(std::size_t slot,
+                              const TauAnalysisRecord &record) {
+  std::vector<TauAnalysisRecord> &buffer = m_buffers.at(slot);
+  buffer.push_back(record);
+  if (buffer.size() >= m_bufferSize) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    fill(buffer);
+  }
+}
+
+void TauAnalysisWriter::flush() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (std::vector<TauAnalysisRecord> &buffer : m_buffers) {
+    fill(buffer);
+  }
+}
+
+void TauAnalysisWriter::close() {
+  flush();
+  // Destroying the writer writes the remaining clusters and the footer
+  m_ntuple.reset();
+}
+
+void TauAnalysisWriter::fill(std::vector<TauAnalysisRecord> &buffer) {
+  for (const TauAnalysisRecord &record : buffer) {
+    if (m_layout == LAYOUT_COMPACT) {
+      m_compact.channel = record.channel;
+      m_compact.phiCP_truth = record.phiCP_truth;
+      m_compact.phiCP_recon = record.phiCP_recon;
+      m_compact.d0_sig_tau_pos_track = record.d0_sig_tau_pos_track;
+      m_compact.d0_sig_tau_neg_track = record.d0_sig_tau_neg_track;
+      m_compact.y_tau_pos_track = record.y_tau_pos_track;
+      m_compact.y_tau_neg_track = record.y_tau_neg_track;
+      m_compact.yy_tau_tracks = record.yy_tau_tracks;
+      m_compact.tau_jets_vtx_diff = record.tau_jets_vtx_diff;
+      std::copy(record.phiCP_recon_variations,
+                record.phiCP_recon_variations + m_variations.size(),
+                m_compact.phiCP_recon_variations);
+    } else {
+      std::fill(&m_phiCP[0][0], &m_phiCP[0][0] + 2 * CHANNEL_COUNT, -99.0);
+      if (record.channel != CHANNEL_NONE) {
+        m_phiCP[record.channel][TRUTH] = record.phiCP_truth;
+        m_phiCP[record.channel][RECON] = record.phiCP_recon;
+      }
+      m_record = record;
+    }
+
+    if (m_ntuple) {
+      m_ntuple->writer->Fill(*m_ntuple->entry);
+    } else {
+      m_tree->Fill();
+    }
+  }
+  buffer.clear();
+}
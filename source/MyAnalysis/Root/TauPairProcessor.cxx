@@ -0,0 +1,568 @@
+#include "AsgMessaging/MessageCheck.h"
+#include <MyAnalysis/CandidateTable.h>
+#include <MyAnalysis/Observables.h>
+#include <MyAnalysis/TauPairProcessor.h>
+#include <MyAnalysis/Utils.h>
+#include <TruthUtils/AtlasPID.h>
+#include <algorithm>
+
+namespace {
+
+/* Inputs shared by the channel handlers */
+struct ChannelInput {
+  const TauPairEvent &event;
+  const TauDecay &tauPos;
+  const TauDecay &tauNeg;
+  CandidateTable &candidates;
+  Vec3D beamSpot;
+  Vec3D primaryVertex;
+  const std::vector<PhiCPVariation> &variations;
+};
+
+/**
+ * Checks the candidates of one channel and computes its observables into the
+ * record. Returns false and sets the failed cut if the event is excluded.
+ */
+using ChannelHandler = bool (*)(const ChannelInput &input,
+                                TauAnalysisRecord &record, Cut &failedCut,
+                                StageClock *clock);
+
+/* Reconstructed phiCP of one channel under a variation */
+using ReconFunction = double (*)(const ChannelInput &input,
+                                 const PhiCPVariation &variation);
+
+const int DECAY_MODE_COUNT = UNKNOWN + 1;
+
+const PhiCPVariation NOMINAL_VARIATION;
+
+/* The lepton of a leptonic decay, otherwise the leading charged pion */
+const TruthParticleRecord &chargedDaughter(const TauDecay &tau) {
+  return tau.decayMode == LEPTONIC ? tau.lepton() : tau.chargedPion();
+}
+
+/* The phiCP of the leptonic channels is shifted by pi, -99 is kept */
+double leptonicCorrection(double phiCP) {
+  if (phiCP == -99.0) {
+    return phiCP;
+  }
+  return phiCP < M_PI ? phiCP + M_PI : phiCP - M_PI;
+}
+
+/* Whether the truth impact parameter of the daughter can be computed */
+bool hasTruthVertices(const TruthParticleRecord &daughter,
+                      const TauDecay &tau) {
+  return daughter.hasProductionVertex && tau.tau.hasProductionVertex;
+}
+
+/**
+ * Truth phiCP of two impact parameter decays, pions or leptons, -99 if a
+ * production vertex is missing from the truth record.
+ */
+double truthPhiCP_IP(const ChannelInput &input, StageClock *clock) {
+  const TruthParticleRecord &daughterPos = chargedDaughter(input.tauPos);
+  const TruthParticleRecord &daughterNeg = chargedDaughter(input.tauNeg);
+  if (!hasTruthVertices(daughterPos, input.tauPos) ||
+      !hasTruthVertices(daughterNeg, input.tauNeg)) {
+    return -99.0;
+  }
+  Vec3D imParamPos = calculateImpactParameter(
+      daughterPos.productionVertex, daughterPos.p4.vect(),
+      input.tauPos.tau.productionVertex);
+  Vec3D imParamNeg = calculateImpactParameter(
+      daughterNeg.productionVertex, daughterNeg.p4.vect(),
+      input.tauNeg.tau.productionVertex);
+  lapStage(clock, STAGE_IMPACT_PARAMETERS);
+  double phiCP =
+      phiCP_ImpactParameter(imParamPos, imParamNeg, daughterPos.p4,
+                            daughterNeg.p4, daughterPos.p4 + daughterNeg.p4);
+  lapStage(clock, STAGE_PHICP);
+  return phiCP;
+}
+
+/* Visible decay products of a row: track and neutral PFOs for a rho */
+Vec4D visibleP4(const ChannelInput &input, int row) {
+  const CandidateTable &candidates = input.candidates;
+  const TauDecay &tau = row == CANDIDATE_POS ? input.tauPos : input.tauNeg;
+  if (tau.decayMode == HADRONIC_1P1N || tau.decayMode == HADRONIC_1PXN) {
+    return candidates.chargedP4[row] + candidates.neutralP4[row];
+  }
+  return candidates.trackP4[row];
+}
+
+/* Reference frame of the variation, the channel's own one if nominal */
+Vec4D referenceFrame(const ChannelInput &input,
+                     const PhiCPVariation &variation, const Vec4D &nominal) {
+  const CandidateTable &candidates = input.candidates;
+  switch (variation.frame) {
+  case FRAME_VISIBLE:
+    return visibleP4(input, CANDIDATE_POS) + visibleP4(input, CANDIDATE_NEG);
+  case FRAME_CANDIDATES:
+    return candidates.p4[CANDIDATE_POS] + candidates.p4[CANDIDATE_NEG];
+  case FRAME_TRUTH_TAUS:
+    return input.tauPos.tau.p4 + input.tauNeg.tau.p4;
+  default:
+    return nominal;
+  }
+}
+
+/* Origin of the impact parameters, nominally the vertex of the given jet */
+Vec3D impactParameterOrigin(const ChannelInput &input,
+                            const PhiCPVariation &variation, int jetRow) {
+  if (variation.origin == ORIGIN_PRIMARY_VERTEX) {
+    return input.primaryVertex - input.beamSpot;
+  }
+  return input.candidates.vertex[jetRow] - input.beamSpot;
+}
+
+/* The pi shift of the leptonic channels, unless the variation drops it */
+double leptonicShift(double phiCP, const PhiCPVariation &variation) {
+  return variation.leptonicShift ? leptonicCorrection(phiCP) : phiCP;
+}
+
+/* Nominal and varied reconstructed phiCP of the event into the record */
+template <ReconFunction Recon>
+void reconstructPhiCP(const ChannelInput &input, TauAnalysisRecord &record) {
+  record.phiCP_recon = Recon(input, NOMINAL_VARIATION);
+  for (std::size_t i = 0; i < input.variations.size(); i++) {
+    record.phiCP_recon_variations[i] = Recon(input, input.variations[i]);
+  }
+}
+
+/* pion+ pion-, each impact parameter w.r.t. the vertex of its own jet */
+double reconPionPion(const ChannelInput &input,
+                     const PhiCPVariation &variation) {
+  const CandidateTable &candidates = input.candidates;
+  Vec3D pionPosImParam = calculateTrackImpactParameter(
+      candidates.track[CANDIDATE_POS],
+      impactParameterOrigin(input, variation, CANDIDATE_POS));
+  Vec3D pionNegImParam = calculateTrackImpactParameter(
+      candidates.track[CANDIDATE_NEG],
+      impactParameterOrigin(input, variation, CANDIDATE_NEG));
+
+  Vec4D trackP4Pos = candidates.trackP4[CANDIDATE_POS];
+  Vec4D trackP4Neg = candidates.trackP4[CANDIDATE_NEG];
+  return phiCP_ImpactParameter(
+      pionPosImParam, pionNegImParam, trackP4Pos, trackP4Neg,
+      referenceFrame(input, variation, trackP4Pos + trackP4Neg));
+}
+
+/* lepton pion, both impact parameters w.r.t. the vertex of the tau jet */
+template <bool LeptonPositive>
+double reconLeptonPion(const ChannelInput &input,
+                       const PhiCPVariation &variation) {
+  const CandidateTable &candidates = input.candidates;
+  const int jetRow = candidateRow(!LeptonPositive);
+  const int leptonRow = candidateRow(LeptonPositive);
+
+  Vec3D origin = impactParameterOrigin(input, variation, jetRow);
+  Vec3D pionPosImParam =
+      calculateTrackImpactParameter(candidates.track[CANDIDATE_POS], origin);
+  Vec3D pionNegImParam =
+      calculateTrackImpactParameter(candidates.track[CANDIDATE_NEG], origin);
+
+  double phiCP = phiCP_ImpactParameter(
+      pionPosImParam, pionNegImParam, candidates.trackP4[CANDIDATE_POS],
+      candidates.trackP4[CANDIDATE_NEG],
+      referenceFrame(input, variation,
+                     candidates.p4[jetRow] + candidates.p4[leptonRow]));
+  return leptonicShift(phiCP, variation);
+}
+
+/* rho rho, from the decay planes alone */
+double reconRhoRho(const ChannelInput &input, const PhiCPVariation &variation) {
+  const CandidateTable &candidates = input.candidates;
+  Vec4D chargedP4Pos = candidates.chargedP4[CANDIDATE_POS];
+  Vec4D chargedP4Neg = candidates.chargedP4[CANDIDATE_NEG];
+  return phiCP_Pion_RhoDecayPlane(
+      chargedP4Pos, candidates.neutralP4[CANDIDATE_POS], chargedP4Neg,
+      candidates.neutralP4[CANDIDATE_NEG],
+      referenceFrame(input, variation, chargedP4Pos + chargedP4Neg));
+}
+
+/* pion or lepton against a rho, the impact parameter w.r.t. the rho jet */
+template <bool RhoPositive>
+double reconImpactParameterRho(const ChannelInput &input,
+                               const PhiCPVariation &variation) {
+  const CandidateTable &candidates = input.candidates;
+  const int rhoRow = candidateRow(RhoPositive);
+  const int ipRow = candidateRow(!RhoPositive);
+
+  Vec3D trackImParam = calculateTrackImpactParameter(
+      candidates.track[ipRow], impactParameterOrigin(input, variation, rhoRow));
+  return phiCP_IP_Rho(
+      trackImParam, candidates.trackP4[ipRow], candidates.chargedP4[rhoRow],
+      candidates.neutralP4[rhoRow],
+      referenceFrame(input, variation,
+                     candidates.p4[rhoRow] + candidates.p4[ipRow]),
+      RhoPositive);
+}
+
+template <bool RhoPositive>
+double reconLeptonRho(const ChannelInput &input,
+                      const PhiCPVariation &variation) {
+  return leptonicShift(reconImpactParameterRho<RhoPositive>(input, variation),
+                       variation);
+}
+
+/**
+ * Truth phiCP and cut variables of an impact parameter decay against a rho
+ * decay, shared by the pion-rho and lepton-rho channels.
+ */
+template <bool RhoPositive>
+void impactParameterRho(const ChannelInput &input, TauAnalysisRecord &record,
+                        StageClock *clock) {
+  const TauDecay &rhoTau = RhoPositive ? input.tauPos : input.tauNeg;
+  const TauDecay &ipTau = RhoPositive ? input.tauNeg : input.tauPos;
+  CandidateTable &candidates = input.candidates;
+  const int rhoRow = candidateRow(RhoPositive);
+  const int ipRow = candidateRow(!RhoPositive);
+
+  candidates.fillD0Significance(ipRow, input.event.eventInfo);
+  candidates.fillRhoSums(rhoRow);
+  lapStage(clock, STAGE_IMPACT_PARAMETERS);
+
+  // The truth phiCP keeps -99 without the production vertices
+  const TruthParticleRecord &daughter = chargedDaughter(ipTau);
+  if (hasTruthVertices(daughter, ipTau)) {
+    Vec3D imParam =
+        calculateImpactParameter(daughter.productionVertex, daughter.p4.vect(),
+                                 ipTau.tau.productionVertex);
+    lapStage(clock, STAGE_IMPACT_PARAMETERS);
+    record.phiCP_truth = phiCP_IP_Rho(
+        imParam, daughter.p4, rhoTau.chargedPion().p4, rhoTau.neutralPionsP4,
+        input.tauPos.tau.p4 + input.tauNeg.tau.p4, RhoPositive);
+    lapStage(clock, STAGE_PHICP);
+  }
+
+  double &d0Sig =
+      RhoPositive ? record.d0_sig_tau_neg_track : record.d0_sig_tau_pos_track;
+  d0Sig = candidates.d0Significance[ipRow];
+  double &y = RhoPositive ? record.y_tau_pos_track : record.y_tau_neg_track;
+  y = candidates.rhoUpsilon[rhoRow];
+}
+
+/* tau+ tau- -> pion+ pion- */
+bool processPionPion(const ChannelInput &input, TauAnalysisRecord &record,
+                     Cut &failedCut, StageClock *clock) {
+  CandidateTable &candidates = input.candidates;
+  if (!candidates.has(CANDIDATE_POS) || !candidates.has(CANDIDATE_NEG)) {
+    failedCut = CUT_TAU_JETS;
+    return false;
+  }
+
+  if (!candidates.hasVertex[CANDIDATE_POS] ||
+      !candidates.hasVertex[CANDIDATE_NEG]) {
+    failedCut = CUT_TAU_VERTICES;
+    return false;
+  }
+  lapStage(clock, STAGE_SELECTION);
+
+  candidates.fillD0Significance(CANDIDATE_POS, input.event.eventInfo);
+  candidates.fillD0Significance(CANDIDATE_NEG, input.event.eventInfo);
+  lapStage(clock, STAGE_IMPACT_PARAMETERS);
+
+  record.tau_jets_vtx_diff =
+      (candidates.vertex[CANDIDATE_POS] - candidates.vertex[CANDIDATE_NEG])
+          .mag();
+
+  record.phiCP_truth = truthPhiCP_IP(input, clock);
+
+  record.d0_sig_tau_pos_track = candidates.d0Significance[CANDIDATE_POS];
+  record.d0_sig_tau_neg_track = candidates.d0Significance[CANDIDATE_NEG];
+
+  reconstructPhiCP<reconPionPion>(input, record);
+  return true;
+}
+
+/* tau+ tau- -> lepton pion, the lepton with the charge of LeptonPositive */
+template <bool LeptonPositive>
+bool processLeptonPion(const ChannelInput &input, TauAnalysisRecord &record,
+                       Cut &failedCut, StageClock *clock) {
+  CandidateTable &candidates = input.candidates;
+  const int jetRow = candidateRow(!LeptonPositive);
+
+  if (!candidates.has(jetRow)) {
+    failedCut = CUT_TAU_JETS;
+    return false;
+  }
+
+  if (!candidates.has(candidateRow(LeptonPositive))) {
+    failedCut = CUT_LEPTON;
+    return false;
+  }
+
+  if (!candidates.hasVertex[jetRow]) {
+    failedCut = CUT_TAU_VERTICES;
+    return false;
+  }
+  lapStage(clock, STAGE_SELECTION);
+
+  candidates.fillD0Significance(CANDIDATE_POS, input.event.eventInfo);
+  candidates.fillD0Significance(CANDIDATE_NEG, input.event.eventInfo);
+  lapStage(clock, STAGE_IMPACT_PARAMETERS);
+
+  record.phiCP_truth = leptonicCorrection(truthPhiCP_IP(input, clock));
+
+  record.d0_sig_tau_pos_track = candidates.d0Significance[CANDIDATE_POS];
+  record.d0_sig_tau_neg_track = candidates.d0Significance[CANDIDATE_NEG];
+
+  reconstructPhiCP<reconLeptonPion<LeptonPositive>>(input, record);
+  return true;
+}
+
+/* tau+ tau- -> rho rho, each of them 1p1n or 1pXn */
+bool processRhoRho(const ChannelInput &input, TauAnalysisRecord &record,
+                   Cut &failedCut, StageClock *clock) {
+  CandidateTable &candidates = input.candidates;
+  if (!candidates.has(CANDIDATE_POS) || !candidates.has(CANDIDATE_NEG)) {
+    failedCut = CUT_TAU_JETS;
+    return false;
+  }
+
+  if (!candidates.hasVertex[CANDIDATE_POS] ||
+      !candidates.hasVertex[CANDIDATE_NEG]) {
+    failedCut = CUT_TAU_VERTICES;
+    return false;
+  }
+  lapStage(clock, STAGE_SELECTION);
+
+  candidates.fillRhoSums(CANDIDATE_POS);
+  candidates.fillRhoSums(CANDIDATE_NEG);
+  lapStage(clock, STAGE_IMPACT_PARAMETERS);
+
+  record.tau_jets_vtx_diff =
+      (candidates.vertex[CANDIDATE_POS] - candidates.vertex[CANDIDATE_NEG])
+          .mag();
+
+  const TauDecay &tauPos = input.tauPos;
+  const TauDecay &tauNeg = input.tauNeg;
+  record.phiCP_truth = phiCP_Pion_RhoDecayPlane(
+      tauPos.chargedPion().p4, tauPos.neutralPionsP4, tauNeg.chargedPion().p4,
+      tauNeg.neutralPionsP4, tauPos.tau.p4 + tauNeg.tau.p4);
+  lapStage(clock, STAGE_PHICP);
+
+  record.y_tau_pos_track = candidates.rhoUpsilon[CANDIDATE_POS];
+  record.y_tau_neg_track = candidates.rhoUpsilon[CANDIDATE_NEG];
+  record.yy_tau_tracks = record.y_tau_pos_track * record.y_tau_neg_track;
+
+  reconstructPhiCP<reconRhoRho>(input, record);
+  return true;
+}
+
+/* tau+ tau- -> pion rho, the rho with the charge of RhoPositive */
+template <bool RhoPositive>
+bool processPionRho(const ChannelInput &input, TauAnalysisRecord &record,
+                    Cut &failedCut, StageClock *clock) {
+  const CandidateTable &candidates = input.candidates;
+  if (!candidates.has(CANDIDATE_POS) || !candidates.has(CANDIDATE_NEG)) {
+    failedCut = CUT_TAU_JETS;
+    return false;
+  }
+
+  if (!candidates.hasVertex[candidateRow(RhoPositive)]) {
+    failedCut = CUT_TAU_VERTICES;
+    return false;
+  }
+  lapStage(clock, STAGE_SELECTION);
+
+  impactParameterRho<RhoPositive>(input, record, clock);
+  reconstructPhiCP<reconImpactParameterRho<RhoPositive>>(input, record);
+  return true;
+}
+
+/* tau+ tau- -> lepton rho, the rho with the charge of RhoPositive */
+template <bool RhoPositive>
+bool processLeptonRho(const ChannelInput &input, TauAnalysisRecord &record,
+                      Cut &failedCut, StageClock *clock) {
+  const CandidateTable &candidates = input.candidates;
+  const int rhoRow = candidateRow(RhoPositive);
+
+  if (!candidates.has(rhoRow)) {
+    failedCut = CUT_TAU_JETS;
+    return false;
+  }
+
+  if (!candidates.has(candidateRow(!RhoPositive))) {
+    failedCut = CUT_LEPTON;
+    return false;
+  }
+
+  if (!candidates.hasVertex[rhoRow]) {
+    failedCut = CUT_TAU_VERTICES;
+    return false;
+  }
+  lapStage(clock, STAGE_SELECTION);
+
+  impactParameterRho<RhoPositive>(input, record, clock);
+  record.phiCP_truth = leptonicCorrection(record.phiCP_truth);
+  reconstructPhiCP<reconLeptonRho<RhoPositive>>(input, record);
+  return true;
+}
+
+/* A decay channel, the decay modes it is reconstructed from and its handler */
+struct ChannelEntry {
+  TauDecayMode tauNeg;
+  TauDecayMode tauPos;
+  DecayChannel channel;
+  ChannelHandler handler;
+};
+
+/**
+ * The only mapping of decay modes to channels: decayChannelOf(), and with it
+ * the cutflow, the event index and the channel filter, as well as the dispatch
+ * of process() are built from it. Pairs not listed are excluded by classify().
+ * A new channel only needs its handler and entries here.
+ */
+constexpr ChannelEntry CHANNELS[] = {
+    {HADRONIC_1P0N, HADRONIC_1P0N, CHANNEL_1P0N_1P0N, processPionPion},
+    {LEPTONIC, HADRONIC_1P0N, CHANNEL_LEPT_1P0N, processLeptonPion<false>},
+    {HADRONIC_1P0N, LEPTONIC, CHANNEL_LEPT_1P0N, processLeptonPion<true>},
+
+    {HADRONIC_1P1N, HADRONIC_1P1N, CHANNEL_1P1N_1P1N, processRhoRho},
+    {HADRONIC_1P1N, HADRONIC_1PXN, CHANNEL_1P1N_1PXN, processRhoRho},
+    {HADRONIC_1PXN, HADRONIC_1P1N, CHANNEL_1P1N_1PXN, processRhoRho},
+
+    {HADRONIC_1P0N, HADRONIC_1P1N, CHANNEL_1P0N_1P1N, processPionRho<true>},
+    {HADRONIC_1P0N, HADRONIC_1PXN, CHANNEL_1P0N_1PXN, processPionRho<true>},
+
+    {LEPTONIC, HADRONIC_1P1N, CHANNEL_LEPT_1P1N, processLeptonRho<true>},
+    {LEPTONIC, HADRONIC_1PXN, CHANNEL_LEPT_1PXN, processLeptonRho<true>}};
+
+/* The entries of CHANNELS indexed by the decay modes of the tau- and tau+ */
+struct ChannelTable {
+  DecayChannel channels[DECAY_MODE_COUNT][DECAY_MODE_COUNT];
+  ChannelHandler handlers[DECAY_MODE_COUNT][DECAY_MODE_COUNT];
+};
+
+constexpr ChannelTable makeChannelTable() {
+  ChannelTable table{};
+  for (const ChannelEntry &entry : CHANNELS) {
+    table.channels[entry.tauNeg][entry.tauPos] = entry.channel;
+    table.handlers[entry.tauNeg][entry.tauPos] = entry.handler;
+  }
+  return table;
+}
+
+constexpr ChannelTable CHANNEL_TABLE = makeChannelTable();
+
+} // namespace
+
+DecayChannel decayChannelOf(TauDecayMode tauNeg, TauDecayMode tauPos) {
+  if (tauNeg < 0 || tauNeg >= DECAY_MODE_COUNT || tauPos < 0 ||
+      tauPos >= DECAY_MODE_COUNT) {
+    return CHANNEL_NONE;
+  }
+  return CHANNEL_TABLE.channels[tauNeg][tauPos];
+}
+
+const char *recoContainerName(int index) {
+  static const char *const NAMES[RECO_CONTAINER_COUNT] = {
+      "EventInfo", "PrimaryVertices", "TauJets", "Electrons", "Muons"};
+  return index >= 0 && index < RECO_CONTAINER_COUNT ? NAMES[index] : "";
+}
+
+TauPairProcessor::TauPairProcessor(const std::string &name)
+    : asg::AsgMessaging(name) {}
+
+unsigned TauPairProcessor::classify(const TauPairEvent &event,
+                                    TruthDecayIndex &truthDecays,
+                                    Cut &failedCut) const {
+  // Retrieve Higgs decay products
+  truthDecays.findHiggsDecay(event.truthHiggs);
+
+  if (truthDecays.higgs() == nullptr) {
+    failedCut = CUT_HIGGS;
+    return RECO_NONE;
+  }
+
+  if (!truthDecays.hasTauPair()) {
+    failedCut = CUT_TAU_PAIR;
+    return RECO_NONE;
+  }
+
+  // Retrieve tau decay products and identify the tau decay modes
+  truthDecays.indexTauDecays(event.truthTaus);
+
+  const TauDecay &tauPos = truthDecays.tauPos();
+  const TauDecay &tauNeg = truthDecays.tauNeg();
+
+  if (decayChannelOf(tauNeg.decayMode, tauPos.decayMode) == CHANNEL_NONE) {
+    failedCut = CUT_CHANNEL;
+    return RECO_NONE;
+  }
+
+  // Every channel needs the beam spot, the primary vertex and the tau jets,
+  // the leptonic ones also the reconstructed leptons of the truth flavour
+  unsigned containers = RECO_EVENT_INFO | RECO_VERTICES | RECO_TAU_JETS;
+  for (const TauDecay *tau : {&tauPos, &tauNeg}) {
+    if (tau->decayMode == TauDecayMode::LEPTONIC) {
+      containers |= std::abs(tau->lepton().particle->pdgId()) == MUON
+                        ? RECO_MUONS
+                        : RECO_ELECTRONS;
+    }
+  }
+  return containers;
+}
+
+bool TauPairProcessor::process(const TauPairEvent &event,
+                               const TruthDecayIndex &truthDecays,
+                               TauAnalysisRecord &record, Cut &failedCut,
+                               StageClock *clock) const {
+  const xAOD::EventInfo *eventInfo = event.eventInfo;
+
+  // Retrieve beamspot and primary vertex
+  Vec3D beamSpot{eventInfo->beamPosX(), eventInfo->beamPosY(),
+                 eventInfo->beamPosZ()};
+
+  Vec3D primaryVertex{0, 0, 0};
+  bool foundPrimaryVertex = false;
+
+  for (const xAOD::Vertex *vertex : *event.vertices) {
+    if (vertex->vertexType() == xAOD::VxType::PriVtx) {
+      primaryVertex = GetVertexVector(vertex);
+      foundPrimaryVertex = true;
+    }
+  }
+
+  if (!foundPrimaryVertex) {
+    failedCut = CUT_PRIMARY_VERTEX;
+    return false;
+  }
+  lapStage(clock, STAGE_PRIMARY_VERTEX);
+
+  // The truth decays were indexed by classify()
+  const TauDecay &tauPos = truthDecays.tauPos();
+  const TauDecay &tauNeg = truthDecays.tauNeg();
+
+  // Construct phiCP observables
+  ChannelHandler handler =
+      CHANNEL_TABLE.handlers[tauNeg.decayMode][tauPos.decayMode];
+  if (handler == nullptr) {
+    failedCut = CUT_CHANNEL;
+    return false;
+  }
+
+  // Every candidate is selected and read from the EDM once
+  CandidateTable candidates;
+  candidates.fill(event, truthDecays);
+
+  if (!handler({event, tauPos, tauNeg, candidates, beamSpot, primaryVertex,
+                m_variations},
+               record, failedCut, clock)) {
+    return false;
+  }
+  record.channel = CHANNEL_TABLE.channels[tauNeg.decayMode][tauPos.decayMode];
+  lapStage(clock, STAGE_PHICP);
+
+  ANA_MSG_DEBUG("Found higgs -> tau+ tau- decay in channel "
+                << decayChannelName(record.channel));
+  return true;
+}
+
+void TauPairProcessor::setVariations(
+    const std::vector<PhiCPVariation> &variations) {
+  m_variations.assign(variations.begin(),
+                      variations.begin() +
+                          std::min<std::size_t>(variations.size(),
+                                                MAX_PHICP_VARIATIONS));
+}
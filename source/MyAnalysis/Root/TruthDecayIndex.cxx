@@ -0,0 +1,112 @@
+#include <MyAnalysis/TruthDecayIndex.h>
+#include <MyAnalysis/Utils.h>
+#include <TruthUtils/AtlasPID.h>
+
+namespace {
+
+TruthParticleRecord makeRecord(const xAOD::TruthParticle *particle) {
+  return {particle, GetP4(particle), GetProductionVertexVector(particle),
+          particle->prodVtx() != nullptr};
+}
+
+void reset(TauDecay &decay, const xAOD::TruthParticle *tau) {
+  decay.tau = tau != nullptr ? makeRecord(tau) : TruthParticleRecord{};
+  decay.chargedPions.clear();
+  decay.neutralPions.clear();
+  decay.leptons.clear();
+  decay.neutrinoCount = 0;
+  decay.neutralPionsP4 = {0.0, 0.0, 0.0, 0.0};
+  decay.decayMode = UNKNOWN;
+}
+
+/* Sorts one child of the tau into its species */
+void addChild(TauDecay &decay, const xAOD::TruthParticle *particle) {
+  switch (particle->pdgId()) {
+  case PIPLUS:
+  case PIMINUS:
+    decay.chargedPions.push_back(makeRecord(particle));
+    break;
+  case PI0:
+    decay.neutralPions.push_back(makeRecord(particle));
+    decay.neutralPionsP4 += decay.neutralPions.back().p4;
+    break;
+  case MUON:
+  case ELECTRON:
+  case -MUON:
+  case POSITRON:
+    // Only count leptons with the charge of the tau
+    if ((particle->pdgId() > 0) == (decay.tau.particle->pdgId() > 0)) {
+      decay.leptons.push_back(makeRecord(particle));
+    }
+    break;
+  case NU_TAU:
+  case -NU_TAU:
+  case NU_E:
+  case -NU_E:
+  case NU_MU:
+  case -NU_MU:
+    decay.neutrinoCount++;
+    break;
+  }
+}
+
+} // namespace
+
+void TruthDecayIndex::findHiggsDecay(
+    const xAOD::TruthParticleContainer *particles) {
+  const xAOD::TruthParticle *tauPos = nullptr;
+  const xAOD::TruthParticle *tauNeg = nullptr;
+  m_higgs = nullptr;
+  m_tauCount = 0;
+
+  for (const xAOD::TruthParticle *particle : *particles) {
+    // Skip higgs bosons
+    if (particle->nParents() == 0) {
+      continue;
+    }
+
+    // Skip particles which are not directly decay products of the Higgs boson
+    const xAOD::TruthParticle *parent = particle->parent(0);
+    if (parent->pdgId() != HIGGSBOSON) {
+      continue;
+    }
+
+    if (particle->pdgId() == TAU) {
+      tauNeg = particle;
+      m_higgs = parent;
+      m_tauCount++;
+    } else if (particle->pdgId() == -TAU) {
+      tauPos = particle;
+      m_tauCount++;
+    }
+  }
+
+  reset(m_tauPos, tauPos);
+  reset(m_tauNeg, tauNeg);
+}
+
+void TruthDecayIndex::indexTauDecays(
+    const xAOD::TruthParticleContainer *particles) {
+  const int tauPosBarcode = m_tauPos.tau.particle->barcode();
+  const int tauNegBarcode = m_tauNeg.tau.particle->barcode();
+
+  for (const xAOD::TruthParticle *particle : *particles) {
+    // Skip tauons
+    if (particle->nParents() == 0) {
+      continue;
+    }
+
+    const int parentBarcode = particle->parent(0)->barcode();
+    if (parentBarcode == tauNegBarcode) {
+      addChild(m_tauNeg, particle);
+    } else if (parentBarcode == tauPosBarcode) {
+      addChild(m_tauPos, particle);
+    }
+  }
+
+  for (TauDecay *decay : {&m_tauPos, &m_tauNeg}) {
+    decay->decayMode = inferTauDecayMode(
+        decay->leptons.size(), decay->chargedPions.size(),
+        decay->neutralPions.size(), decay->neutrinoCount);
+  }
+}
@@ -1,644 +1,526 @@
 #include "AsgMessaging/MessageCheck.h"
-#include "MyAnalysis/Observables.h"
-#include "xAODEgamma/Electron.h"
-#include "xAODTracking/TrackParticlexAODHelpers.h"
-#include "xAODTruth/TruthParticleContainer.h"
-#include "xAODTruth/versions/TruthVertex_v1.h"
 #include <MyAnalysis/TruthLevelAnalysis.h>
-#include <MyAnalysis/Utils.h>
+#include <TH1.h>
+#include <TFile.h>
+#include <TH2.h>
 #include <TTree.h>
-#include <TruthUtils/AtlasPID.h>
-#include <xAODEventInfo/EventInfo.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#ifdef XAOD_STANDALONE
+#include "xAODCore/tools/IOStats.h"
+#include "xAODCore/tools/ReadStats.h"
+#include <EventLoop/Worker.h>
+#endif
 
 TruthLevelAnalysis::TruthLevelAnalysis(const std::string &name,
                                        ISvcLocator *pSvcLocator)
-    : EL::AnaAlgorithm(name, pSvcLocator) {}
-
-StatusCode TruthLevelAnalysis::initialize() {
-  ANA_CHECK(book(TTree("tau_analysis", "tau analysis")));
-  TTree *myTree = tree("tau_analysis");
-
-  // Hadronic observables
-  myTree->Branch("phiCP_1p0n_1p0n_truth", &m_phiCP_1p0n_1p0n_truth);
-  myTree->Branch("phiCP_1p0n_1p0n_recon", &m_phiCP_1p0n_1p0n_recon);
-  myTree->Branch("phiCP_1p0n_1p1n_truth", &m_phiCP_1p0n_1p1n_truth);
-  myTree->Branch("phiCP_1p0n_1p1n_recon", &m_phiCP_1p0n_1p1n_recon);
-  myTree->Branch("phiCP_1p0n_1pXn_truth", &m_phiCP_1p0n_1pXn_truth);
-  myTree->Branch("phiCP_1p0n_1pXn_recon", &m_phiCP_1p0n_1pXn_recon);
-  myTree->Branch("phiCP_1p1n_1p1n_truth", &m_phiCP_1p1n_1p1n_truth);
-  myTree->Branch("phiCP_1p1n_1p1n_recon", &m_phiCP_1p1n_1p1n_recon);
-  myTree->Branch("phiCP_1p1n_1pXn_truth", &m_phiCP_1p1n_1pXn_truth);
-  myTree->Branch("phiCP_1p1n_1pXn_recon", &m_phiCP_1p1n_1pXn_recon);
-
-  // Leptonic observables
-  myTree->Branch("phiCP_lept_1p0n_truth", &m_phiCP_lept_1p0n_truth);
-  myTree->Branch("phiCP_lept_1p0n_recon", &m_phiCP_lept_1p0n_recon);
-  myTree->Branch("phiCP_lept_1p1n_truth", &m_phiCP_lept_1p1n_truth);
-  myTree->Branch("phiCP_lept_1p1n_recon", &m_phiCP_lept_1p1n_recon);
-  myTree->Branch("phiCP_lept_1pXn_truth", &m_phiCP_lept_1pXn_truth);
-  myTree->Branch("phiCP_lept_1pXn_recon", &m_phiCP_lept_1pXn_recon);
-
-  // For applying cuts
-  myTree->Branch("d0_sig_tau_pos_track", &m_d0_sig_tau_pos_track);
-  myTree->Branch("d0_sig_tau_neg_track", &m_d0_sig_tau_neg_track);
-  myTree->Branch("y_tau_pos_track", &m_y_tau_pos_track);
-  myTree->Branch("y_tau_neg_track", &m_y_tau_neg_track);
-  myTree->Branch("yy_tau_tracks", &m_yy_tau_tracks);
-
-  // For debugging purposes
-  myTree->Branch("tau_jets_vtx_diff", &m_tau_jets_vtx_diff);
-
-  return StatusCode::SUCCESS;
+    : EL::AnaAlgorithm(name, pSvcLocator), m_processor(name) {
+  declareProperty("OutputFormat", m_outputFormat = "ttree",
+                  "Storage format of tau_analysis, ttree or rntuple");
+  declareProperty("OutputLayout", m_outputLayout = "wide",
+                  "Branch layout of the tau_analysis tree, wide or compact");
+  declareProperty("BasketSize", m_basketSize = 0,
+                  "Basket size of the output branches, 0 for the default");
+  declareProperty("PageSize", m_pageSize = 0,
+                  "RNTuple page size in bytes, 0 for the default");
+  declareProperty("ClusterSize", m_clusterSize = 0,
+                  "RNTuple compressed cluster size in bytes, 0 for the "
+                  "default");
+  declareProperty("Compression", m_compression = -1,
+                  "ROOT compression settings of the output branches, -1 to "
+                  "use the settings of the output file");
+  declareProperty("FillHistograms", m_fillHistograms = false,
+                  "Fill the per-channel phiCP histograms");
+  declareProperty("D0SigCut", m_d0SigCut = 3.0,
+                  "Minimum |d0 significance| of the d0sig histograms");
+  declareProperty("YYCut", m_yyCut = 0.1,
+                  "Minimum |y+ y-| of the yy histograms");
+  declareProperty("FillFourierMoments", m_fillFourierMoments = false,
+                  "Estimate the CP phase of every channel from the Fourier "
+                  "moments of phiCP");
+  declareProperty("BootstrapReplicas", m_bootstrapReplicas = 0,
+                  "Number of Poisson bootstrap replicas of the Fourier "
+                  "moments, 0 to disable");
+  declareProperty("BootstrapSeed", m_bootstrapSeed = 0,
+                  "Seed of the bootstrap weights, combined with the event "
+                  "number");
+  declareProperty("PrintReadStats", m_printReadStats = false,
+                  "Print the bytes read, read calls and decompression time "
+                  "of every input container, needs the xAOD PerfStats of "
+                  "the job");
+  declareProperty("TimeStages", m_timeStages = false,
+                  "Time the stages of every event per channel, summarised "
+                  "in finalize and stored as stageTime histograms");
+  declareProperty("Channels", m_channels = "",
+                  "Comma-separated decay channels to process, e.g. "
+                  "1p0n_1p0n,lept_1p0n, selected with the event index "
+                  "sidecars of the input files. Other entries are still "
+                  "looped over, but none of their containers is read. Empty "
+                  "for all events");
+  declareProperty("EventLimit", m_eventLimit = -1,
+                  "Entries of the selected Channels to process, -1 for all. "
+                  "Use it instead of the limit of the job, which counts the "
+                  "skipped entries too");
+  declareProperty("EventIndexDir", m_eventIndexDir = "",
+                  "Directory buildEventIndex --output-dir wrote the event "
+                  "indices to, empty if they are next to the input files");
+  declareProperty("Variations", m_variations = "",
+                  "Comma-separated variations of the reconstructed phiCP, "
+                  "e.g. truthtaus,pv_noshift, each written to a "
+                  "phiCP_recon_<variation> column. See PhiCPVariation.h");
 }
 
-StatusCode TruthLevelAnalysis::execute() {
-  m_phiCP_1p0n_1p0n_truth = -99.0;
-  m_phiCP_1p0n_1p0n_recon = -99.0;
-  m_phiCP_1p0n_1p1n_truth = -99.0;
-  m_phiCP_1p0n_1p1n_recon = -99.0;
-  m_phiCP_1p0n_1pXn_truth = -99.0;
-  m_phiCP_1p0n_1pXn_recon = -99.0;
-  m_phiCP_1p1n_1p1n_truth = -99.0;
-  m_phiCP_1p1n_1p1n_recon = -99.0;
-  m_phiCP_1p1n_1pXn_truth = -99.0;
-  m_phiCP_1p1n_1pXn_recon = -99.0;
-
-  m_phiCP_lept_1p0n_truth = -99.0;
-  m_phiCP_lept_1p0n_recon = -99.0;
-  m_phiCP_lept_1p1n_truth = -99.0;
-  m_phiCP_lept_1p1n_recon = -99.0;
-  m_phiCP_lept_1pXn_truth = -99.0;
-  m_phiCP_lept_1pXn_recon = -99.0;
-
-  m_d0_sig_tau_pos_track = -99.0;
-  m_d0_sig_tau_neg_track = -99.0;
-
-  m_y_tau_pos_track = -99.0;
-  m_y_tau_neg_track = -99.0;
-  m_yy_tau_tracks = -99.0;
-
-  m_tau_jets_vtx_diff = -99.0;
-
-  // Containers
-  const xAOD::EventInfo *eventInfo = nullptr;
-  const xAOD::TruthParticleContainer *truthHiggsWithDecayParticles = nullptr;
-  const xAOD::TruthParticleContainer *truthTausWithDecayParticles = nullptr;
-  const xAOD::TauJetContainer *tauJets = nullptr;
-  const xAOD::ElectronContainer *electrons = nullptr;
-  const xAOD::VertexContainer *vertices = nullptr;
-
-  // Truth particles
-  const xAOD::TruthParticle *pHiggs = nullptr;
-  const xAOD::TruthParticle *pTauPos = nullptr;
-  const xAOD::TruthParticle *pTauNeg = nullptr;
-  const xAOD::TruthParticle *pPionPos = nullptr;
-  const xAOD::TruthParticle *pPionNeg = nullptr;
-  std::vector<const xAOD::TruthParticle *> pPionZerosOfTauPos;
-  std::vector<const xAOD::TruthParticle *> pPionZerosOfTauNeg;
-  const xAOD::TruthParticle *pLeptonNeg = nullptr;
-  const xAOD::TruthParticle *pLeptonPos = nullptr;
-
-  // Retrieve containers
-  ANA_CHECK(evtStore()->retrieve(eventInfo, "EventInfo"));
-  ANA_CHECK(evtStore()->retrieve(truthTausWithDecayParticles,
-                                 "TruthTausWithDecayParticles"));
-  ANA_CHECK(evtStore()->retrieve(tauJets, "TauJets"));
-  ANA_CHECK(evtStore()->retrieve(electrons, "Electrons"));
-  ANA_CHECK(evtStore()->retrieve(vertices, "PrimaryVertices"));
+StatusCode TruthLevelAnalysis::initialize() {
+  m_processor.setLevel(msg().level());
 
-  StatusCode result = evtStore()->retrieve(truthHiggsWithDecayParticles,
-                                           "TruthBSMWithDecayParticles");
-  if (result.isFailure() || truthHiggsWithDecayParticles->empty()) {
-    ANA_CHECK(evtStore()->retrieve(truthHiggsWithDecayParticles,
-                                   "TruthBosonsWithDecayParticles"));
-    ANA_MSG_VERBOSE("No BSM Higgs found, falling back to standard Higgs.");
-  } else {
-    ANA_MSG_VERBOSE("Found BSM Higgs with decay products.");
+  OutputFormat format;
+  if (!parseOutputFormat(m_outputFormat, format)) {
+    ANA_MSG_ERROR("Unknown output format " << m_outputFormat);
+    return StatusCode::FAILURE;
   }
 
-  // Retrieve beamspot and primary vertex
-  TVector3 beamSpot(eventInfo->beamPosX(), eventInfo->beamPosY(),
-                    eventInfo->beamPosZ());
-
-  TVector3 primaryVertex(0, 0, 0);
-  bool foundPrimaryVertex = false;
-
-  for (const xAOD::Vertex *vertex : *vertices) {
-    if (vertex->vertexType() == xAOD::VxType::PriVtx) {
-      primaryVertex = GetVertexVector(vertex);
-      foundPrimaryVertex = true;
-    }
+  TauAnalysisWriter::Options options;
+  if (!parseOutputLayout(m_outputLayout, options.layout)) {
+    ANA_MSG_ERROR("Unknown output layout " << m_outputLayout);
+    return StatusCode::FAILURE;
   }
-
-  if (!foundPrimaryVertex) {
-    ANA_MSG_VERBOSE("No primary vertex found. Excluding event.");
-    return StatusCode::SUCCESS;
+  options.basketSize = m_basketSize;
+  options.pageSize = std::max(m_pageSize, 0);
+  options.clusterSize = std::max(m_clusterSize, 0);
+  options.compression = m_compression;
+  // There is a single event slot, so every record is written as it comes and
+  // the output stage times the fill of its own event
+  options.bufferSize = 1;
+
+  std::vector<PhiCPVariation> variations;
+  if (!parseVariationList(m_variations, variations)) {
+    ANA_MSG_ERROR("Invalid phiCP variations " << m_variations);
+    return StatusCode::FAILURE;
   }
-
-  // Retrieve Higgs decay products
-  int tauCount = 0;
-
-  for (const xAOD::TruthParticle *particle : *truthHiggsWithDecayParticles) {
-    // Skip higgs bosons
-    if (particle->nParents() == 0) {
-      continue;
-    }
-
-    // Skip particles which are not directly decay products of the Higgs boson
-    if (particle->parent(0)->pdgId() != HIGGSBOSON) {
-      continue;
-    }
-
-    if (particle->pdgId() == TAU) {
-      pTauNeg = particle;
-      pHiggs = particle->parent(0);
-      tauCount++;
-    } else if (particle->pdgId() == -TAU) {
-      pTauPos = particle;
-      tauCount++;
-    }
+  m_processor.setVariations(variations);
+  for (const PhiCPVariation &variation : variations) {
+    options.variations.push_back(variation.name);
   }
 
-  if (pHiggs == nullptr) {
-    ANA_MSG_VERBOSE("Higgs boson not found. Excluding event.");
-    return StatusCode::SUCCESS;
+  if (!m_channels.empty()) {
+#ifdef XAOD_STANDALONE
+    if (!parseChannelList(m_channels, m_selectedChannels)) {
+      ANA_MSG_ERROR("Unknown decay channel in " << m_channels);
+      return StatusCode::FAILURE;
+    }
+    ANA_CHECK(requestBeginInputFile());
+#else
+    ANA_MSG_ERROR("The channel filter is only supported in EventLoop");
+    return StatusCode::FAILURE;
+#endif
   }
 
-  if (pTauNeg == nullptr || pTauPos == nullptr || tauCount != 2) {
-    ANA_MSG_VERBOSE(
-        "Could not find tau+ tau- decay products. Excluding event.");
-    return StatusCode::SUCCESS;
+  if (format == FORMAT_RNTUPLE) {
+#ifdef XAOD_STANDALONE
+    // Written next to the trees booked in the ANALYSIS output stream
+    m_writer.attach(wk()->getOutputFile("ANALYSIS"), "tau_analysis", options);
+#else
+    ANA_MSG_ERROR("RNTuple output is only supported in EventLoop");
+    return StatusCode::FAILURE;
+#endif
+  } else {
+    ANA_CHECK(book(TTree("tau_analysis", "tau analysis")));
+    m_writer.attach(tree("tau_analysis"), options);
   }
 
-  // Retrieve tau decay products
-  int tauPosLeptonCount = 0;
-  int tauNegLeptonCount = 0;
-  int tauPosPionZeroCount = 0;
-  int tauNegPionZeroCount = 0;
-  int tauPosPionChargedCount = 0;
-  int tauNegPionChargedCount = 0;
-  int tauPosNeutrinoCount = 0;
-  int tauNegNeutrinoCount = 0;
-
-  for (const xAOD::TruthParticle *particle : *truthTausWithDecayParticles) {
-    // Skip tauons
-    if (particle->nParents() == 0) {
-      continue;
+  if (m_fillHistograms) {
+    PhiCPHistograms::Cuts cuts;
+    cuts.d0Sig = m_d0SigCut;
+    cuts.yy = m_yyCut;
+    bool booked = m_histograms.book(cuts, [this](const TH1F &prototype) {
+      return registerHist(prototype);
+    });
+    if (!booked) {
+      ANA_MSG_ERROR("Failed to book the phiCP histograms");
+      return StatusCode::FAILURE;
     }
+  }
 
-    const xAOD::TruthParticle *parent = particle->parent(0);
-
-    // Tau-
-    if (parent->barcode() == pTauNeg->barcode()) {
-      switch (particle->pdgId()) {
-      case PIPLUS:
-        pPionPos = particle;
-        tauNegPionChargedCount++;
-        break;
-      case PIMINUS:
-        pPionNeg = particle;
-        tauNegPionChargedCount++;
-        break;
-      case PI0:
-        tauNegPionZeroCount++;
-        pPionZerosOfTauNeg.push_back(particle);
-        break;
-      case MUON:
-      case ELECTRON:
-        pLeptonNeg = particle;
-        tauNegLeptonCount++;
-        break;
-      case NU_TAU:
-      case -NU_TAU:
-      case NU_E:
-      case -NU_E:
-      case NU_MU:
-      case -NU_MU:
-        tauNegNeutrinoCount++;
-        break;
+  if (m_fillFourierMoments) {
+    for (int channel = CHANNEL_NONE + 1; channel < CHANNEL_COUNT; channel++) {
+      for (int kind : {0, 1}) {
+        std::string name =
+            std::string("fourierMoments_") +
+            decayChannelName(static_cast<DecayChannel>(channel)) +
+            (kind == 0 ? "_truth" : "_recon");
+        m_momentHists[channel][kind] =
+            registerHist(FourierMoments::makeHistogram(name.c_str()));
+        if (m_momentHists[channel][kind] == nullptr) {
+          ANA_MSG_ERROR("Failed to book " << name);
+          return StatusCode::FAILURE;
+        }
       }
     }
+  }
 
-    // Tau+
-    else if (parent->barcode() == pTauPos->barcode()) {
-      switch (particle->pdgId()) {
-      case PIPLUS:
-        pPionPos = particle;
-        tauPosPionChargedCount++;
-        break;
-      case PIMINUS:
-        pPionNeg = particle;
-        tauPosPionChargedCount++;
-        break;
-      case PI0:
-        tauPosPionZeroCount++;
-        pPionZerosOfTauPos.push_back(particle);
-        break;
-      case -MUON:
-      case POSITRON:
-        pLeptonPos = particle;
-        tauPosLeptonCount++;
-        break;
-      case NU_TAU:
-      case -NU_TAU:
-      case NU_E:
-      case -NU_E:
-      case NU_MU:
-      case -NU_MU:
-        tauPosNeutrinoCount++;
-        break;
+  if (m_bootstrapReplicas > 0) {
+    m_bootstrapWeights.resize(m_bootstrapReplicas);
+    for (int channel = CHANNEL_NONE + 1; channel < CHANNEL_COUNT; channel++) {
+      for (int kind : {0, 1}) {
+        std::string name =
+            std::string("bootstrap_") +
+            decayChannelName(static_cast<DecayChannel>(channel)) +
+            (kind == 0 ? "_truth" : "_recon");
+        m_bootstrap[channel][kind] = BootstrapReplicas(m_bootstrapReplicas);
+        m_bootstrapHists[channel][kind] = registerHist(
+            m_bootstrap[channel][kind].makeHistogram(name.c_str()));
+        if (m_bootstrapHists[channel][kind] == nullptr) {
+          ANA_MSG_ERROR("Failed to book " << name);
+          return StatusCode::FAILURE;
+        }
       }
     }
   }
 
-  // Identify tau decay mode and construct phiCP observables
-  TauDecayMode tauNegDecayMode =
-      inferTauDecayMode(tauNegLeptonCount, tauNegPionChargedCount,
-                        tauNegPionZeroCount, tauNegNeutrinoCount);
-  TauDecayMode tauPosDecayMode =
-      inferTauDecayMode(tauPosLeptonCount, tauPosPionChargedCount,
-                        tauPosPionZeroCount, tauPosNeutrinoCount);
-
-  if (tauNegDecayMode == TauDecayMode::HADRONIC_1P0N &&
-      tauPosDecayMode == TauDecayMode::HADRONIC_1P0N) {
-    if (tauJets == nullptr || tauJets->size() < 2) {
-      ANA_MSG_VERBOSE("Not enough tau jets found. Excluding event.");
-      return StatusCode::SUCCESS;
-    }
-
-    const xAOD::TauJet *tauPosJet = GetLeadingJet(tauJets, true);
-    const xAOD::TauJet *tauNegJet = GetLeadingJet(tauJets, false);
-
-    if (tauPosJet == nullptr || tauNegJet == nullptr) {
-      ANA_MSG_VERBOSE("Could not find tau+ or tau- jets. Excluding event.");
-      return StatusCode::SUCCESS;
+  for (int channel = CHANNEL_NONE + 1; channel <= CHANNEL_COUNT; channel++) {
+    std::string name =
+        channel == CHANNEL_COUNT
+            ? std::string("cutflow")
+            : std::string("cutflow_") +
+                  decayChannelName(static_cast<DecayChannel>(channel));
+    m_cutflowHists[channel] =
+        registerHist(Cutflow::makeHistogram(name.c_str()));
+    if (m_cutflowHists[channel] == nullptr) {
+      ANA_MSG_ERROR("Failed to book " << name);
+      return StatusCode::FAILURE;
     }
+  }
 
-    if (tauPosJet->vertex() == nullptr || tauNegJet->vertex() == nullptr) {
-      ANA_MSG_VERBOSE("Could not find tau+ or tau- vertex. Excluding event.");
-      return StatusCode::SUCCESS;
-    }
-
-    ANA_MSG_DEBUG("Found higgs -> tau+ tau- -> pion+ pion- decay");
-
-    m_tau_jets_vtx_diff = (GetVertexVector(tauPosJet->vertex()) -
-                           GetVertexVector(tauNegJet->vertex()))
-                              .Mag();
-
-    TVector3 imParamPos = calculateImpactParameter(
-        pPionPos->prodVtx()->v4().Vect(), pPionPos->p4().Vect(),
-        pTauPos->prodVtx()->v4().Vect());
-    TVector3 imParamNeg = calculateImpactParameter(
-        pPionNeg->prodVtx()->v4().Vect(), pPionNeg->p4().Vect(),
-        pTauNeg->prodVtx()->v4().Vect());
-    m_phiCP_1p0n_1p0n_truth =
-        phiCP_ImpactParameter(imParamPos, imParamNeg, pPionPos->p4(),
-                              pPionNeg->p4(), pPionPos->p4() + pPionNeg->p4());
-
-    const xAOD::TrackParticle *tauPosTrack = tauPosJet->track(0)->track();
-    const xAOD::TrackParticle *tauNegTrack = tauNegJet->track(0)->track();
-
-    m_d0_sig_tau_pos_track = xAOD::TrackingHelpers::d0significance(
-        tauPosTrack, eventInfo->beamPosSigmaX(), eventInfo->beamPosSigmaY(),
-        eventInfo->beamPosSigmaXY());
-    m_d0_sig_tau_neg_track = xAOD::TrackingHelpers::d0significance(
-        tauNegTrack, eventInfo->beamPosSigmaX(), eventInfo->beamPosSigmaY(),
-        eventInfo->beamPosSigmaXY());
-
-    TVector3 pionPosImParamJetVertex = calculateTrackImpactParameter(
-        tauPosTrack, GetVertexVector(tauPosJet->vertex()) - beamSpot);
-    TVector3 pionNegImParamJetVertex = calculateTrackImpactParameter(
-        tauNegTrack, GetVertexVector(tauNegJet->vertex()) - beamSpot);
-
-    m_phiCP_1p0n_1p0n_recon = phiCP_ImpactParameter(
-        pionPosImParamJetVertex, pionNegImParamJetVertex, tauPosTrack->p4(),
-        tauNegTrack->p4(), tauPosTrack->p4() + tauNegTrack->p4());
-  } else if (tauNegDecayMode == TauDecayMode::LEPTONIC &&
-             tauPosDecayMode == TauDecayMode::HADRONIC_1P0N) {
-    const xAOD::TauJet *tauPosJet = GetLeadingJet(tauJets, true);
-    const xAOD::Electron *electron = GetLeadingElectron(electrons, false);
-
-    if (tauPosJet == nullptr) {
-      ANA_MSG_VERBOSE("Could not find tau+ jet. Excluding event.");
-      return StatusCode::SUCCESS;
+  if (m_timeStages) {
+    bool booked = m_stageTimers.book([this](const TH1D &prototype) {
+      return registerHist(prototype);
+    });
+    if (!booked) {
+      ANA_MSG_ERROR("Failed to book the stage time histograms");
+      return StatusCode::FAILURE;
     }
+  }
 
-    if (electron == nullptr) {
-      ANA_MSG_VERBOSE("Could not find tau- lepton. Excluding event.");
-      return StatusCode::SUCCESS;
-    }
+  m_bytesReadAtStart = TFile::GetFileBytesRead();
 
-    ANA_MSG_DEBUG("Found higgs -> tau+ tau- -> pion+ lepton- decay");
-
-    TVector3 imParamPos = calculateImpactParameter(
-        pPionPos->prodVtx()->v4().Vect(), pPionPos->p4().Vect(),
-        pTauPos->prodVtx()->v4().Vect());
-    TVector3 imParamNeg = calculateImpactParameter(
-        pLeptonNeg->prodVtx()->v4().Vect(), pLeptonNeg->p4().Vect(),
-        pTauNeg->prodVtx()->v4().Vect());
-    m_phiCP_lept_1p0n_truth = phiCP_ImpactParameter(
-        imParamPos, imParamNeg, pPionPos->p4(), pLeptonNeg->p4(),
-        pPionPos->p4() + pLeptonNeg->p4());
-
-    const xAOD::TrackParticle *tauPosTrack = tauPosJet->track(0)->track();
-    const xAOD::TrackParticle *tauNegTrack = electron->trackParticle(0);
-
-    m_d0_sig_tau_pos_track = xAOD::TrackingHelpers::d0significance(
-        tauPosTrack, eventInfo->beamPosSigmaX(), eventInfo->beamPosSigmaY(),
-        eventInfo->beamPosSigmaXY());
-    m_d0_sig_tau_neg_track = xAOD::TrackingHelpers::d0significance(
-        tauNegTrack, eventInfo->beamPosSigmaX(), eventInfo->beamPosSigmaY(),
-        eventInfo->beamPosSigmaXY());
-
-    TVector3 pionPosImParam = calculateTrackImpactParameter(
-        tauPosTrack, GetVertexVector(tauPosJet->vertex()) - beamSpot);
-    TVector3 pionNegImParam = calculateTrackImpactParameter(
-        tauNegTrack, GetVertexVector(tauPosJet->vertex()) - beamSpot);
-
-    m_phiCP_lept_1p0n_recon = phiCP_ImpactParameter(
-        pionPosImParam, pionNegImParam, tauPosTrack->p4(), tauNegTrack->p4(),
-        tauPosJet->p4() + electron->p4());
-
-    // leptonic correction:
-    m_phiCP_lept_1p0n_truth = m_phiCP_lept_1p0n_truth < M_PI
-                                  ? m_phiCP_lept_1p0n_truth + M_PI
-                                  : m_phiCP_lept_1p0n_truth - M_PI;
-    m_phiCP_lept_1p0n_recon = m_phiCP_lept_1p0n_recon < M_PI
-                                  ? m_phiCP_lept_1p0n_recon + M_PI
-                                  : m_phiCP_lept_1p0n_recon - M_PI;
-  } else if (tauNegDecayMode == TauDecayMode::HADRONIC_1P0N &&
-             tauPosDecayMode == TauDecayMode::LEPTONIC) {
-    const xAOD::TauJet *tauNegJet = GetLeadingJet(tauJets, false);
-    const xAOD::Electron *positron = GetLeadingElectron(electrons, true);
-
-    if (tauNegJet == nullptr) {
-      ANA_MSG_VERBOSE("Could not find tau+ jet. Excluding event.");
-      return StatusCode::SUCCESS;
-    }
+  return StatusCode::SUCCESS;
+}
 
-    if (positron == nullptr) {
-      ANA_MSG_VERBOSE("Could not find tau- lepton. Excluding event.");
+StatusCode TruthLevelAnalysis::execute() {
+#ifdef XAOD_STANDALONE
+  // Entries of other channels are skipped before any container is read. The
+  // event loop itself still visits them, so the event limit is applied here
+  // to the selected entries only.
+  if (!m_channels.empty()) {
+    if (!std::binary_search(m_entryList.begin(), m_entryList.end(),
+                            wk()->treeEntry())) {
       return StatusCode::SUCCESS;
     }
-
-    ANA_MSG_DEBUG("Found higgs -> tau+ tau- -> lepton+ pion- decay");
-
-    TVector3 imParamPos = calculateImpactParameter(
-        pLeptonPos->prodVtx()->v4().Vect(), pLeptonPos->p4().Vect(),
-        pTauPos->prodVtx()->v4().Vect());
-    TVector3 imParamNeg = calculateImpactParameter(
-        pPionNeg->prodVtx()->v4().Vect(), pPionNeg->p4().Vect(),
-        pTauNeg->prodVtx()->v4().Vect());
-    m_phiCP_lept_1p0n_truth = phiCP_ImpactParameter(
-        imParamPos, imParamNeg, pLeptonPos->p4(), pPionNeg->p4(),
-        pLeptonPos->p4() + pPionNeg->p4());
-
-    const xAOD::TrackParticle *tauNegTrack = tauNegJet->track(0)->track();
-    const xAOD::TrackParticle *tauPosTrack = positron->trackParticle(0);
-
-    m_d0_sig_tau_pos_track = xAOD::TrackingHelpers::d0significance(
-        tauPosTrack, eventInfo->beamPosSigmaX(), eventInfo->beamPosSigmaY(),
-        eventInfo->beamPosSigmaXY());
-    m_d0_sig_tau_neg_track = xAOD::TrackingHelpers::d0significance(
-        tauNegTrack, eventInfo->beamPosSigmaX(), eventInfo->beamPosSigmaY(),
-        eventInfo->beamPosSigmaXY());
-
-    TVector3 pionPosImParam = calculateTrackImpactParameter(
-        tauPosTrack, GetVertexVector(tauNegJet->vertex()) - beamSpot);
-    TVector3 pionNegImParam = calculateTrackImpactParameter(
-        tauNegTrack, GetVertexVector(tauNegJet->vertex()) - beamSpot);
-    m_phiCP_lept_1p0n_recon = phiCP_ImpactParameter(
-        pionPosImParam, pionNegImParam, tauPosTrack->p4(), tauNegTrack->p4(),
-        tauNegJet->p4() + positron->p4());
-
-    // leptonic correction:
-    m_phiCP_lept_1p0n_truth = m_phiCP_lept_1p0n_truth < M_PI
-                                  ? m_phiCP_lept_1p0n_truth + M_PI
-                                  : m_phiCP_lept_1p0n_truth - M_PI;
-    m_phiCP_lept_1p0n_recon = m_phiCP_lept_1p0n_recon < M_PI
-                                  ? m_phiCP_lept_1p0n_recon + M_PI
-                                  : m_phiCP_lept_1p0n_recon - M_PI;
-  } else if ((tauNegDecayMode == TauDecayMode::HADRONIC_1P1N &&
-              tauPosDecayMode == TauDecayMode::HADRONIC_1P1N) ||
-             (tauNegDecayMode == TauDecayMode::HADRONIC_1P1N &&
-              tauPosDecayMode == TauDecayMode::HADRONIC_1PXN) ||
-             (tauNegDecayMode == TauDecayMode::HADRONIC_1PXN &&
-              tauPosDecayMode == TauDecayMode::HADRONIC_1P1N)) {
-    if (tauJets == nullptr || tauJets->size() < 2) {
-      ANA_MSG_VERBOSE("Not enough tau jets found. Excluding event.");
+    if (m_eventLimit >= 0 && m_selectedEvents >= m_eventLimit) {
       return StatusCode::SUCCESS;
     }
+    m_selectedEvents++;
+  }
+#endif
 
-    const xAOD::TauJet *tauPosJet = GetLeadingJet(tauJets, true);
-    const xAOD::TauJet *tauNegJet = GetLeadingJet(tauJets, false);
-
-    if (tauPosJet == nullptr || tauNegJet == nullptr) {
-      ANA_MSG_VERBOSE("Could not find tau+ or tau- jets. Excluding event.");
-      return StatusCode::SUCCESS;
-    }
+  StageClock *clock = m_timeStages ? &m_clock : nullptr;
+  if (clock != nullptr) {
+    clock->start();
+  }
 
-    if (tauPosJet->vertex() == nullptr || tauNegJet->vertex() == nullptr) {
-      ANA_MSG_VERBOSE("Could not find tau+ or tau- vertex. Excluding event.");
-      return StatusCode::SUCCESS;
-    }
+  // Everything transient lives on the arena until the next event
+  m_arena.reset();
+  TruthDecayIndex truthDecays(&m_arena);
+  TauPairEvent event;
 
-    ANA_MSG_DEBUG("Found higgs -> tau+ tau- -> pion+ pion- pion0 decay");
+  // Retrieve the truth containers, most events are excluded by them alone
+  ANA_CHECK(evtStore()->retrieve(event.truthTaus,
+                                 "TruthTausWithDecayParticles"));
 
-    m_tau_jets_vtx_diff = (GetVertexVector(tauPosJet->vertex()) -
-                           GetVertexVector(tauNegJet->vertex()))
-                              .Mag();
+  StatusCode result = evtStore()->retrieve(event.truthHiggs,
+                                           "TruthBSMWithDecayParticles");
+  if (result.isFailure() || event.truthHiggs->empty()) {
+    ANA_CHECK(evtStore()->retrieve(event.truthHiggs,
+                                   "TruthBosonsWithDecayParticles"));
+    ANA_MSG_VERBOSE("No BSM Higgs found, falling back to standard Higgs.");
+  } else {
+    ANA_MSG_VERBOSE("Found BSM Higgs with decay products.");
+  }
 
-    // sum over neutral pions
-    TLorentzVector chargedP4Pos = pPionPos->p4();
-    TLorentzVector neutralP4Pos(0.0, 0.0, 0.0, 0.0);
-    for (const xAOD::TruthParticle *pionZero : pPionZerosOfTauPos) {
-      neutralP4Pos += pionZero->p4();
-    }
+  lapStage(clock, STAGE_RETRIEVE_TRUTH);
 
-    TLorentzVector chargedP4Neg = pPionNeg->p4();
-    TLorentzVector neutralP4Neg(0.0, 0.0, 0.0, 0.0);
-    for (const xAOD::TruthParticle *pionZero : pPionZerosOfTauNeg) {
-      neutralP4Neg += pionZero->p4();
+  Cut failedCut = CUT_COUNT;
+  unsigned containers = m_processor.classify(event, truthDecays, failedCut);
+  lapStage(clock, STAGE_TRUTH_DECAYS);
+  if (containers == RECO_NONE) {
+    m_cutflow.fail(CHANNEL_NONE, failedCut);
+    if (clock != nullptr) {
+      m_stageTimers.fill(CHANNEL_NONE, *clock);
     }
+    return StatusCode::SUCCESS;
+  }
+  const DecayChannel truthChannel = decayChannelOf(
+      truthDecays.tauNeg().decayMode, truthDecays.tauPos().decayMode);
 
-    double phiCP_truth =
-        phiCP_Pion_RhoDecayPlane(chargedP4Pos, neutralP4Pos, chargedP4Neg,
-                                 neutralP4Neg, pTauPos->p4() + pTauNeg->p4());
+  // Only the reconstruction containers of the event's channel are read
+  ANA_CHECK(retrieveReco(containers, event));
+  lapStage(clock, STAGE_RETRIEVE_RECO);
 
-    chargedP4Pos.SetPxPyPzE(0.0, 0.0, 0.0, 0.0);
-    for (auto track : tauPosJet->tracks()) {
-      chargedP4Pos += track->track()->p4();
+  TauAnalysisRecord record;
+  if (!m_processor.process(event, truthDecays, record, failedCut, clock)) {
+    m_cutflow.fail(truthChannel, failedCut);
+  } else {
+    m_cutflow.pass(truthChannel);
+    m_writer.write(0, record);
+    if (m_fillHistograms) {
+      m_histograms.fill(record);
+    }
+    if (m_fillFourierMoments && record.channel != CHANNEL_NONE) {
+      if (record.phiCP_truth != -99.0) {
+        m_moments[record.channel][0].add(record.phiCP_truth);
+      }
+      if (record.phiCP_recon != -99.0) {
+        m_moments[record.channel][1].add(record.phiCP_recon);
+      }
     }
-
-    neutralP4Pos.SetPxPyPzE(0.0, 0.0, 0.0, 0.0);
-    for (size_t i = 0; i < tauPosJet->nNeutralPFOs(); ++i) {
-      neutralP4Pos += tauPosJet->neutralPFO(i)->p4();
+    if (m_bootstrapReplicas > 0 && record.channel != CHANNEL_NONE) {
+      // Keyed by the event number, so every job gives an event the same
+      // weights
+      BootstrapReplicas::eventWeights(event.eventInfo->eventNumber(),
+                                      m_bootstrapSeed, m_bootstrapReplicas,
+                                      m_bootstrapWeights.data());
+      if (record.phiCP_truth != -99.0) {
+        m_bootstrap[record.channel][0].add(record.phiCP_truth,
+                                           m_bootstrapWeights.data());
+      }
+      if (record.phiCP_recon != -99.0) {
+        m_bootstrap[record.channel][1].add(record.phiCP_recon,
+                                           m_bootstrapWeights.data());
+      }
     }
+    lapStage(clock, STAGE_OUTPUT);
+  }
 
-    chargedP4Neg.SetPxPyPzE(0.0, 0.0, 0.0, 0.0);
-    for (auto track : tauNegJet->tracks()) {
-      chargedP4Neg += track->track()->p4();
-    }
+  if (clock != nullptr) {
+    // Excluded events count to the channel of their truth decay
+    m_stageTimers.fill(truthChannel, *clock);
+  }
 
-    neutralP4Neg.SetPxPyPzE(0.0, 0.0, 0.0, 0.0);
-    for (size_t i = 0; i < tauNegJet->nNeutralPFOs(); ++i) {
-      neutralP4Neg += tauNegJet->neutralPFO(i)->p4();
-    }
+  return StatusCode::SUCCESS;
+}
 
-    m_y_tau_pos_track = upsilon(chargedP4Pos.E(), neutralP4Pos.E());
-    m_y_tau_neg_track = upsilon(chargedP4Neg.E(), neutralP4Neg.E());
-    m_yy_tau_tracks = m_y_tau_pos_track * m_y_tau_neg_track;
-
-    double phiCP_recon =
-        phiCP_Pion_RhoDecayPlane(chargedP4Pos, neutralP4Pos, chargedP4Neg,
-                                 neutralP4Neg, chargedP4Pos + chargedP4Neg);
-
-    if (tauNegDecayMode == TauDecayMode::HADRONIC_1PXN ||
-        tauPosDecayMode == TauDecayMode::HADRONIC_1PXN) {
-      m_phiCP_1p1n_1pXn_truth = phiCP_truth;
-      m_phiCP_1p1n_1pXn_recon = phiCP_recon;
-    } else {
-      m_phiCP_1p1n_1p1n_truth = phiCP_truth;
-      m_phiCP_1p1n_1p1n_recon = phiCP_recon;
-    }
-  } else if (tauNegDecayMode == TauDecayMode::HADRONIC_1P0N &&
-             (tauPosDecayMode == TauDecayMode::HADRONIC_1P1N ||
-              tauPosDecayMode == TauDecayMode::HADRONIC_1PXN)) {
-    const xAOD::TauJet *tauPosJet = GetLeadingJet(tauJets, true);
-    const xAOD::TauJet *tauNegJet = GetLeadingJet(tauJets, false);
-
-    if (tauPosJet == nullptr) {
-      ANA_MSG_VERBOSE("Could not find tau+ jet. Excluding event.");
-      return StatusCode::SUCCESS;
-    }
+StatusCode TruthLevelAnalysis::beginInputFile() {
+#ifdef XAOD_STANDALONE
+  const std::string path =
+      EventIndex::sidecarPath(wk()->inputFile()->GetName(), m_eventIndexDir);
 
-    if (tauNegJet == nullptr) {
-      ANA_MSG_VERBOSE("Could not find tau- jet. Excluding event.");
-      return StatusCode::SUCCESS;
-    }
-
-    ANA_MSG_DEBUG("Found higgs -> tau+ tau- -> pion+ pion0 pion- decay");
+  EventIndex index;
+  if (!index.read(path)) {
+    ANA_MSG_ERROR("Failed to read the event index "
+                  << path << ", create it with buildEventIndex");
+    return StatusCode::FAILURE;
+  }
+  if (static_cast<long long>(index.size()) != wk()->tree()->GetEntries()) {
+    ANA_MSG_ERROR("The event index " << path
+                                     << " does not match its input file");
+    return StatusCode::FAILURE;
+  }
 
-    // sum over neutral pions
-    TLorentzVector chargedP4Pos = pPionPos->p4();
-    TLorentzVector neutralP4Pos(0.0, 0.0, 0.0, 0.0);
-    for (const xAOD::TruthParticle *pionZero : pPionZerosOfTauPos) {
-      neutralP4Pos += pionZero->p4();
-    }
+  m_entryList = index.entryList(m_selectedChannels);
+  ANA_MSG_INFO("Reading " << m_entryList.size() << " of " << index.size()
+                          << " entries of " << wk()->inputFile()->GetName());
+#endif
+  return StatusCode::SUCCESS;
+}
 
-    TVector3 imParamNeg = calculateImpactParameter(
-        pPionNeg->prodVtx()->v4().Vect(), pPionNeg->p4().Vect(),
-        pTauNeg->prodVtx()->v4().Vect());
-    double phiCP_truth =
-        phiCP_IP_Rho(imParamNeg, pPionNeg->p4(), chargedP4Pos, neutralP4Pos,
-                     pTauPos->p4() + pTauNeg->p4(), true);
+StatusCode TruthLevelAnalysis ::finalize() {
+  m_writer.close();
 
-    const xAOD::TrackParticle *tauNegTrack = tauNegJet->track(0)->track();
+  for (int channel = CHANNEL_NONE + 1; channel <= CHANNEL_COUNT; channel++) {
+    m_cutflow.store(static_cast<DecayChannel>(channel),
+                    *m_cutflowHists[channel]);
+  }
+  ANA_MSG_INFO("Cutflow:\n" << m_cutflow.table());
+  m_arena.flushStats();
+  ANA_MSG_INFO("Event arena: " << m_arena.stats().summary());
 
-    m_d0_sig_tau_neg_track = xAOD::TrackingHelpers::d0significance(
-        tauNegTrack, eventInfo->beamPosSigmaX(), eventInfo->beamPosSigmaY(),
-        eventInfo->beamPosSigmaXY());
+  for (int i = 0; i < RECO_CONTAINER_COUNT; i++) {
+    ANA_MSG_INFO("  " << recoContainerName(i) << " retrieved in "
+                      << m_retrievals[i] << " events");
+  }
+  ANA_MSG_INFO("Bytes read from input files: "
+               << TFile::GetFileBytesRead() - m_bytesReadAtStart);
+  if (m_printReadStats) {
+    printReadStats();
+  }
+  if (m_timeStages) {
+    printStageTimes();
+  }
 
-    chargedP4Pos.SetPxPyPzE(0.0, 0.0, 0.0, 0.0);
-    for (auto track : tauPosJet->tracks()) {
-      chargedP4Pos += track->track()->p4();
+  if (m_fillFourierMoments) {
+    for (int channel = CHANNEL_NONE + 1; channel < CHANNEL_COUNT; channel++) {
+      for (int kind : {0, 1}) {
+        const FourierMoments &moments = m_moments[channel][kind];
+        moments.store(*m_momentHists[channel][kind]);
+
+        FourierMomentResult result = moments.result();
+        if (result.sumWeights == 0.0) {
+          continue;
+        }
+        ANA_MSG_INFO("phiCP_"
+                     << decayChannelName(static_cast<DecayChannel>(channel))
+                     << (kind == 0 ? "_truth" : "_recon") << ": A = "
+                     << result.amplitude << " +- "
+                     << std::sqrt(result.amplitudeVariance)
+                     << ", C = " << result.phase << " +- "
+                     << std::sqrt(result.phaseVariance) << " ("
+                     << result.sumWeights << " events)");
+      }
     }
+  }
 
-    neutralP4Pos.SetPxPyPzE(0.0, 0.0, 0.0, 0.0);
-    for (size_t i = 0; i < tauPosJet->nNeutralPFOs(); ++i) {
-      neutralP4Pos += tauPosJet->neutralPFO(i)->p4();
+  if (m_bootstrapReplicas > 0) {
+    for (int channel = CHANNEL_NONE + 1; channel < CHANNEL_COUNT; channel++) {
+      for (int kind : {0, 1}) {
+        const BootstrapReplicas &replicas = m_bootstrap[channel][kind];
+        replicas.store(*m_bootstrapHists[channel][kind]);
+
+        double amplitudeError, phaseError;
+        replicas.spread(amplitudeError, phaseError);
+        if (replicas.sum(BootstrapReplicas::SUM_W, 0) == 0.0) {
+          continue;
+        }
+        ANA_MSG_INFO("phiCP_"
+                     << decayChannelName(static_cast<DecayChannel>(channel))
+                     << (kind == 0 ? "_truth" : "_recon")
+                     << ": bootstrap errors A +- " << amplitudeError
+                     << ", C +- " << phaseError << " ("
+                     << replicas.size() << " replicas)");
+      }
     }
+  }
 
-    m_y_tau_pos_track = upsilon(chargedP4Pos.E(), neutralP4Pos.E());
-
-    TVector3 pionNegImParam = calculateTrackImpactParameter(
-        tauNegTrack, GetVertexVector(tauPosJet->vertex()) - beamSpot);
-    double phiCP_recon =
-        phiCP_IP_Rho(pionNegImParam, tauNegTrack->p4(), chargedP4Pos,
-                     neutralP4Pos, tauPosJet->p4() + tauNegJet->p4(), true);
-
-    if (tauPosDecayMode == TauDecayMode::HADRONIC_1PXN) {
-      m_phiCP_1p0n_1pXn_truth = phiCP_truth;
-      m_phiCP_1p0n_1pXn_recon = phiCP_recon;
-    } else {
-      m_phiCP_1p0n_1p1n_truth = phiCP_truth;
-      m_phiCP_1p0n_1p1n_recon = phiCP_recon;
-    }
-  } else if (tauNegDecayMode == TauDecayMode::LEPTONIC &&
-             (tauPosDecayMode == TauDecayMode::HADRONIC_1P1N ||
-              tauPosDecayMode == TauDecayMode::HADRONIC_1PXN)) {
-    const xAOD::TauJet *tauPosJet = GetLeadingJet(tauJets, true);
-    const xAOD::Electron *electron = GetLeadingElectron(electrons, false);
-
-    if (tauPosJet == nullptr) {
-      ANA_MSG_VERBOSE("Could not find tau+ jet. Excluding event.");
-      return StatusCode::SUCCESS;
-    }
+  return StatusCode::SUCCESS;
+}
 
-    if (electron == nullptr) {
-      ANA_MSG_VERBOSE("Could not find tau- lepton. Excluding event.");
-      return StatusCode::SUCCESS;
+StatusCode TruthLevelAnalysis::retrieveReco(unsigned containers,
+                                            TauPairEvent &event) {
+  for (int i = 0; i < RECO_CONTAINER_COUNT; i++) {
+    if (containers & (1u << i)) {
+      m_retrievals[i]++;
     }
+  }
 
-    ANA_MSG_DEBUG("Found higgs -> tau+ tau- -> pion+ pion0 lepton- decay");
+  if (containers & RECO_EVENT_INFO) {
+    ANA_CHECK(evtStore()->retrieve(event.eventInfo, "EventInfo"));
+  }
+  if (containers & RECO_VERTICES) {
+    ANA_CHECK(evtStore()->retrieve(event.vertices, "PrimaryVertices"));
+  }
+  if (containers & RECO_TAU_JETS) {
+    ANA_CHECK(evtStore()->retrieve(event.tauJets, "TauJets"));
+  }
+  if (containers & RECO_ELECTRONS) {
+    ANA_CHECK(evtStore()->retrieve(event.electrons, "Electrons"));
+  }
+  if (containers & RECO_MUONS) {
+    ANA_CHECK(evtStore()->retrieve(event.muons, "Muons"));
+  }
+  return StatusCode::SUCCESS;
+}
 
-    // sum over neutral pions
-    TLorentzVector chargedP4Pos = pPionPos->p4();
-    TLorentzVector neutralP4Pos(0.0, 0.0, 0.0, 0.0);
-    for (const xAOD::TruthParticle *pionZero : pPionZerosOfTauPos) {
-      neutralP4Pos += pionZero->p4();
+void TruthLevelAnalysis::printStageTimes() const {
+  ANA_MSG_INFO("Stage times in microseconds:");
+  for (int channel = 0; channel < CHANNEL_COUNT; channel++) {
+    const DecayChannel decayChannel = static_cast<DecayChannel>(channel);
+    if (m_stageTimers.summary(decayChannel, STAGE_RETRIEVE_TRUTH).events ==
+        0.0) {
+      continue;
     }
 
-    TVector3 imParamNeg = calculateImpactParameter(
-        pLeptonNeg->prodVtx()->v4().Vect(), pLeptonNeg->p4().Vect(),
-        pTauNeg->prodVtx()->v4().Vect());
-    double phiCP_truth =
-        phiCP_IP_Rho(imParamNeg, pLeptonNeg->p4(), chargedP4Pos, neutralP4Pos,
-                     pTauPos->p4() + pTauNeg->p4(), true);
-
-    const xAOD::TrackParticle *tauNegTrack = electron->trackParticle(0);
-
-    m_d0_sig_tau_neg_track = xAOD::TrackingHelpers::d0significance(
-        tauNegTrack, eventInfo->beamPosSigmaX(), eventInfo->beamPosSigmaY(),
-        eventInfo->beamPosSigmaXY());
-
-    chargedP4Pos.SetPxPyPzE(0.0, 0.0, 0.0, 0.0);
-    for (auto track : tauPosJet->tracks()) {
-      chargedP4Pos += track->track()->p4();
+    ANA_MSG_INFO("  " << decayChannelName(decayChannel) << ":");
+    char line[128];
+    std::snprintf(line, sizeof(line), "    %-18s %10s %10s %10s %10s",
+                  "stage", "events", "mean", "p50", "p99");
+    ANA_MSG_INFO(line);
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+      StageTimers::Summary summary = m_stageTimers.summary(
+          decayChannel, static_cast<TimedStage>(stage));
+      if (summary.events == 0.0) {
+        continue;
+      }
+      std::snprintf(line, sizeof(line), "    %-18s %10.0f %10.2f %10.2f %10.2f",
+                    timedStageName(static_cast<TimedStage>(stage)),
+                    summary.events, summary.mean / 1e3, summary.p50 / 1e3,
+                    summary.p99 / 1e3);
+      ANA_MSG_INFO(line);
     }
+  }
+}
 
-    neutralP4Pos.SetPxPyPzE(0.0, 0.0, 0.0, 0.0);
-    for (size_t i = 0; i < tauPosJet->nNeutralPFOs(); ++i) {
-      neutralP4Pos += tauPosJet->neutralPFO(i)->p4();
+void TruthLevelAnalysis::printReadStats() const {
+#ifdef XAOD_STANDALONE
+  const xAOD::ReadStats &stats = xAOD::IOStats::instance().stats();
+  ANA_MSG_INFO("Input: " << stats.bytesRead() << " bytes in "
+                         << stats.fileReads() << " read calls, "
+                         << stats.unzipTime() << " s decompressing, "
+                         << stats.cacheSize() << " bytes TTreeCache");
+
+  // The statistics are kept per auxiliary variable, summed per container
+  struct ContainerStats {
+    std::string name;
+    long long reads = 0;
+    long long zippedBytes = 0;
+    long long unzippedBytes = 0;
+    double unzipTime = 0.0;
+  };
+  std::vector<ContainerStats> containers;
+  for (const auto &container : stats.branches()) {
+    ContainerStats sums;
+    sums.name = container.first;
+    for (const xAOD::BranchStats *branch : container.second) {
+      if (branch == nullptr) {
+        continue;
+      }
+      sums.reads += branch->readEntries();
+      sums.zippedBytes += branch->zippedBytesRead();
+      sums.unzippedBytes += branch->unzippedBytesRead();
+      sums.unzipTime += branch->unzipTime();
     }
-
-    m_y_tau_pos_track = upsilon(chargedP4Pos.E(), neutralP4Pos.E());
-
-    TVector3 pionNegImParam = calculateTrackImpactParameter(
-        tauNegTrack, GetVertexVector(tauPosJet->vertex()) - beamSpot);
-    double phiCP_recon =
-        phiCP_IP_Rho(pionNegImParam, tauNegTrack->p4(), chargedP4Pos,
-                     neutralP4Pos, tauPosJet->p4() + electron->p4(), true);
-
-    // leptonic correction:
-    phiCP_truth = phiCP_truth < M_PI ? phiCP_truth + M_PI : phiCP_truth - M_PI;
-    phiCP_recon = phiCP_recon < M_PI ? phiCP_recon + M_PI : phiCP_recon - M_PI;
-
-    if (tauPosDecayMode == TauDecayMode::HADRONIC_1PXN) {
-      m_phiCP_lept_1pXn_truth = phiCP_truth;
-      m_phiCP_lept_1pXn_recon = phiCP_recon;
-    } else {
-      m_phiCP_lept_1p1n_truth = phiCP_truth;
-      m_phiCP_lept_1p1n_recon = phiCP_recon;
+    if (sums.reads > 0) {
+      containers.push_back(sums);
     }
-  } else {
-    ANA_MSG_VERBOSE("Unknown tau+ tau- decay mode. Excluding event.");
-    return StatusCode::SUCCESS;
   }
-
-  tree("tau_analysis")->Fill();
-
-  return StatusCode::SUCCESS;
+  std::sort(containers.begin(), containers.end(),
+            [](const ContainerStats &a, const ContainerStats &b) {
+              return a.zippedBytes > b.zippedBytes;
+            });
+
+  for (const ContainerStats &container : containers) {
+    ANA_MSG_INFO("  " << container.name << ": " << container.zippedBytes
+                      << " bytes (" << container.unzippedBytes
+                      << " unzipped) in " << container.reads
+                      << " branch reads, " << container.unzipTime
+                      << " s decompressing");
+  }
+#else
+  ANA_MSG_WARNING("Read statistics are only available in EventLoop");
+#endif
 }
 
-StatusCode TruthLevelAnalysis ::finalize() { return StatusCode::SUCCESS; }
+TH1 *TruthLevelAnalysis::registerHist(const TH1 &prototype) {
+#ifdef XAOD_STANDALONE
+  // Kept in the ANALYSIS stream next to the ntuple, EventLoop adds them up
+  // when merging the outputs of parallel jobs
+  TH1 *hist = static_cast<TH1 *>(prototype.Clone());
+  hist->SetDirectory(wk()->getOutputFile("ANALYSIS"));
+  return hist;
+#else
+  if (book(prototype).isFailure()) {
+    return nullptr;
+  }
+  return hist(prototype.GetName());
+#endif
+}
@@ -1,33 +1,7 @@
-#include "xAODEgamma/ElectronContainer.h"
-#include "xAODTau/TauJet.h"
-#include "xAODTau/TauJetContainer.h"
 #include <MyAnalysis/Utils.h>
-#include <TVector3.h>
+#include <algorithm>
 #include <cstdlib>
 
-TVector3 getParallelComponent(const TVector3 &vec1, const TVector3 &vec2) {
-  return vec1.Dot(vec2) / vec2.Mag2() * vec2;
-}
-
-TVector3 getPerpendicularComponent(const TVector3 &vec1, const TVector3 &vec2) {
-  return vec1 - getParallelComponent(vec1, vec2);
-}
-
-TVector3 calculateImpactParameter(const TVector3 &trackVtx,
-                                  const TVector3 &trackDirection,
-                                  const TVector3 &primaryVertex) {
-  return getPerpendicularComponent(trackVtx - primaryVertex, trackDirection);
-}
-
-TVector3 calculateTrackImpactParameter(const xAOD::TrackParticle *track,
-                                       const TVector3 &primaryVertex) {
-  TVector3 pointOfClosestApproach =
-      TVector3(-track->d0() * sin(track->phi0()),
-               track->d0() * cos(track->phi0()), track->z0());
-  return calculateImpactParameter(pointOfClosestApproach, track->p4().Vect(),
-                                  primaryVertex);
-}
-
 TauDecayMode inferTauDecayMode(int nLepton, int nPionCharged, int nPionZero,
                                int nNeutrino) {
   if (nLepton == 1 && nPionCharged == 0 && nPionZero == 0 && nNeutrino == 2) {
@@ -53,98 +27,78 @@ TauDecayMode inferTauDecayMode(int nLepton, int nPionCharged, int nPionZero,
   return UNKNOWN;
 }
 
-TVector3 GetVertexVector(const xAOD::Vertex *vertex) {
-  return TVector3(vertex->x(), vertex->y(), vertex->z());
+const char *decayChannelName(DecayChannel channel) {
+  switch (channel) {
+  case CHANNEL_1P0N_1P0N:
+    return "1p0n_1p0n";
+  case CHANNEL_1P0N_1P1N:
+    return "1p0n_1p1n";
+  case CHANNEL_1P0N_1PXN:
+    return "1p0n_1pXn";
+  case CHANNEL_1P1N_1P1N:
+    return "1p1n_1p1n";
+  case CHANNEL_1P1N_1PXN:
+    return "1p1n_1pXn";
+  case CHANNEL_LEPT_1P0N:
+    return "lept_1p0n";
+  case CHANNEL_LEPT_1P1N:
+    return "lept_1p1n";
+  case CHANNEL_LEPT_1PXN:
+    return "lept_1pXn";
+  default:
+    return "none";
+  }
 }
 
-/**
- * From the TauJet container, find the best candidate jet for the given charge.
- * Applies some very basic selection criteria and finds the jet with the highest
- * pT.
- */
-const xAOD::TauJet *GetLeadingJet(const xAOD::TauJetContainer *jets,
-                                  bool positive) {
-  const xAOD::TauJet *leadingJet = nullptr;
-  for (const xAOD::TauJet *jet : *jets) {
-    // Require the jet to have the right charge
-    if ((jet->charge() <= 0 && positive) || (jet->charge() >= 0 && !positive)) {
-      continue;
-    }
+bool parseChannelList(const std::string &list, bool selected[CHANNEL_COUNT]) {
+  std::fill(selected, selected + CHANNEL_COUNT, false);
 
-    // Require 1 or 3 tracks
-    if (jet->nTracks() != 1 && jet->nTracks() != 3) {
-      continue;
+  std::size_t begin = 0;
+  while (begin <= list.size()) {
+    std::size_t end = list.find(',', begin);
+    if (end == std::string::npos) {
+      end = list.size();
     }
-
-    // Require leading track
-    if (jet->track(0) == nullptr || jet->track(0)->track() == nullptr) {
-      continue;
+    std::string name = list.substr(begin, end - begin);
+
+    bool known = false;
+    for (int channel = CHANNEL_NONE + 1; channel < CHANNEL_COUNT; channel++) {
+      if (name == decayChannelName(static_cast<DecayChannel>(channel))) {
+        selected[channel] = true;
+        known = true;
+      }
     }
-
-    // Skip jets below 20 GeV
-    if (jet->pt() < 20000.0) {
-      continue;
-    }
-
-    // Skip jets outside the barrel and endcap regions
-    if (abs(jet->eta()) > 2.47 ||
-        (abs(jet->eta()) > 1.37 && abs(jet->eta()) < 1.52)) {
-      continue;
-    }
-
-    if (leadingJet == nullptr || jet->pt() > leadingJet->pt()) {
-      leadingJet = jet;
+    if (!known) {
+      return false;
     }
+    begin = end + 1;
   }
-
-  return leadingJet;
+  return true;
 }
 
-/**
- * From the Electron container, find the leading electron with the given charge.
- * Applies some very basic selection criteria and finds the electron with the
- * highest pT.
- */
-const xAOD::Electron *
-GetLeadingElectron(const xAOD::ElectronContainer *electrons, bool positive) {
-  const xAOD::Electron *leadingElectron = nullptr;
-  for (const xAOD::Electron *electron : *electrons) {
-    // Require the electron to have the right charge
-    if ((electron->charge() <= 0 && positive) ||
-        (electron->charge() >= 0 && !positive)) {
-      continue;
-    }
+#ifndef MYANALYSIS_KERNELS_ONLY
 
-    // Require 1 track
-    if (electron->nTrackParticles() != 1) {
-      continue;
-    }
-
-    // Require leading track
-    if (electron->trackParticle(0) == nullptr) {
-      continue;
-    }
+#include "xAODTruth/TruthVertex.h"
 
-    // Skip electrons below 20 GeV
-    if (electron->pt() < 20000.0) {
-      continue;
-    }
+Vec3D calculateTrackImpactParameter(const xAOD::TrackParticle *track,
+                                    const Vec3D &primaryVertex) {
+  Vec3D pointOfClosestApproach{-track->d0() * sin(track->phi0()),
+                               track->d0() * cos(track->phi0()), track->z0()};
+  return calculateImpactParameter(pointOfClosestApproach,
+                                  Vec4D::from(track->p4()).vect(),
+                                  primaryVertex);
+}
 
-    // Skip electrons outside the barrel and endcap regions
-    if (abs(electron->eta()) > 2.47 ||
-        (abs(electron->eta()) > 1.37 && abs(electron->eta()) < 1.52)) {
-      continue;
-    }
+Vec3D GetVertexVector(const xAOD::Vertex *vertex) {
+  return {vertex->x(), vertex->y(), vertex->z()};
+}
 
-    if (leadingElectron == nullptr || electron->pt() > leadingElectron->pt()) {
-      leadingElectron = electron;
-    }
+Vec3D GetProductionVertexVector(const xAOD::TruthParticle *particle) {
+  const xAOD::TruthVertex *vertex = particle->prodVtx();
+  if (vertex == nullptr) {
+    return {-99.0, -99.0, -99.0};
   }
-
-  return leadingElectron;
+  return {vertex->x(), vertex->y(), vertex->z()};
 }
 
-/* y = (E_pm - E_0) / (E_pm + E_0) */
-double upsilon(double chargedEnergy, double neutralEnergy) {
-  return (chargedEnergy - neutralEnergy) / (chargedEnergy + neutralEnergy);
-}
\ No newline at end of file
+#endif // MYANALYSIS_KERNELS_ONLY
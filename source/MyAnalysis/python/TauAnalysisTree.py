@@ -0,0 +1,124 @@
+# Helpers to read the tau_analysis ntuple in either output layout and format.
+#
+# The wide layout has one truth/recon branch pair per decay channel. The
+# compact layout stores the channel number and a single phiCP_truth and
+# phiCP_recon pair; these helpers expose it under the wide branch names.
+# The ntuple is either a TTree or, with OutputFormat=rntuple, an RNTuple.
+
+import re
+import types
+
+import ROOT
+
+NAME = "tau_analysis"
+
+# Mirrors the DecayChannel enum in MyAnalysis/Utils.h
+CHANNELS = [
+    "none",
+    "1p0n_1p0n",
+    "1p0n_1p1n",
+    "1p0n_1pXn",
+    "1p1n_1p1n",
+    "1p1n_1pXn",
+    "lept_1p0n",
+    "lept_1p1n",
+    "lept_1pXn",
+]
+
+SENTINEL = -99.0
+
+_PHICP_BRANCH = re.compile(r"^phiCP_(.+)_(truth|recon)$")
+
+
+class Ntuple:
+    """The tau_analysis ntuple of one file, read from a TTree or an RNTuple.
+
+    Iterating yields one entry per event, whose fields are attributes named
+    after the stored columns, as when iterating a TTree in PyROOT.
+    """
+
+    def __init__(self, path, name=NAME):
+        self.file = ROOT.TFile.Open(path)
+        self.tree = None
+        self.rntuple = None
+        self._columns = None
+        if not self.file or self.file.IsZombie():
+            return
+
+        key = self.file.GetKey(name)
+        if key and "RNTuple" in key.GetClassName():
+            self.rntuple = (name, path)
+        else:
+            self.tree = self.file.Get(name)
+
+    def __bool__(self):
+        return bool(self.tree) or self.rntuple is not None
+
+    @property
+    def columns(self):
+        """Columns of an RNTuple, loaded on first use, None for a TTree."""
+        if self._columns is None and self.rntuple is not None:
+            # RDataFrame reads both formats, load the few columns at once
+            self._columns = dict(ROOT.RDataFrame(*self.rntuple).AsNumpy())
+        return self._columns
+
+    def column_names(self):
+        if self.columns is not None:
+            return list(self.columns)
+        return [branch.GetName() for branch in self.tree.GetListOfBranches()]
+
+    def GetEntries(self):
+        if self.columns is not None:
+            return len(next(iter(self.columns.values()), []))
+        return self.tree.GetEntries()
+
+    def __iter__(self):
+        if self.columns is None:
+            yield from self.tree
+            return
+        names = list(self.columns)
+        for values in zip(*self.columns.values()):
+            yield types.SimpleNamespace(**dict(zip(names, values)))
+
+    def histogram(self, name):
+        """Histogram filled by the job with FillHistograms, or None."""
+        hist = self.file.Get(name) if self.file else None
+        if not hist or not hist.InheritsFrom("TH1"):
+            return None
+        return hist
+
+    def Close(self):
+        if self.file:
+            self.file.Close()
+
+
+def is_compact(ntuple):
+    """Whether the ntuple was written with the compact layout."""
+    return "channel" in ntuple.column_names()
+
+
+def branch_names(ntuple):
+    """Names of the wide layout branches available in the ntuple."""
+    names = ntuple.column_names()
+    if not is_compact(ntuple):
+        return names
+
+    wide = [
+        f"phiCP_{channel}_{kind}"
+        for channel in CHANNELS[1:]
+        for kind in ("truth", "recon")
+    ]
+    return wide + [
+        name for name in names if name not in ("channel", "phiCP_truth", "phiCP_recon")
+    ]
+
+
+def branch_value(entry, branch, compact):
+    """Value of a wide layout branch for the current entry."""
+    if compact:
+        match = _PHICP_BRANCH.match(branch)
+        if match and match.group(1) in CHANNELS:
+            if CHANNELS[int(entry.channel)] != match.group(1):
+                return SENTINEL
+            return getattr(entry, f"phiCP_{match.group(2)}")
+    return getattr(entry, branch)
@@ -11,11 +11,14 @@ parser = argparse.ArgumentParser()
 parser.add_argument(
     "-c",
     "--config-path",
-    dest="configPath",
+    dest="configPaths",
     action="store",
+    nargs="+",
     type=str,
     required=True,
-    help="Path to the directory containing samples to be processed.",
+    help="Sample directories to process in one job. Each is a sample named "
+    "after its directory, with its own output data-ANALYSIS/<name>.root, so "
+    "the directory names must be distinct.",
 )
 parser.add_argument(
     "-s",
@@ -33,7 +36,169 @@ parser.add_argument(
     action="store",
     type=int,
     default=500,
-    help="Maximum number of events to process. Use -1 for no limit.",
+    help="Maximum number of events to process per sample. Use -1 for no "
+    "limit. EventLoop applies a limit per worker segment, so a limited job "
+    "runs sequentially and ignores --jobs.",
+)
+parser.add_argument(
+    "-j",
+    "--jobs",
+    dest="jobs",
+    action="store",
+    type=int,
+    default=1,
+    help="Number of local worker processes, shared by all samples. The input "
+    "files are split across them and the outputs of every sample are merged "
+    "into its data-ANALYSIS file. Only used with --event-limit -1.",
+)
+parser.add_argument(
+    "--files-per-worker",
+    dest="filesPerWorker",
+    action="store",
+    type=int,
+    default=1,
+    help="Number of input files processed by each worker if --jobs > 1.",
+)
+parser.add_argument(
+    "--output-format",
+    dest="outputFormat",
+    action="store",
+    choices=["ttree", "rntuple"],
+    default="ttree",
+    help="Storage format of the tau_analysis ntuple.",
+)
+parser.add_argument(
+    "--output-layout",
+    dest="outputLayout",
+    action="store",
+    choices=["wide", "compact"],
+    default="wide",
+    help="Branch layout of the tau_analysis tree.",
+)
+parser.add_argument(
+    "--basket-size",
+    dest="basketSize",
+    action="store",
+    type=int,
+    default=0,
+    help="Basket size of the output branches in bytes. Use 0 for the default.",
+)
+parser.add_argument(
+    "--page-size",
+    dest="pageSize",
+    action="store",
+    type=int,
+    default=0,
+    help="RNTuple page size in bytes. Use 0 for the default.",
+)
+parser.add_argument(
+    "--cluster-size",
+    dest="clusterSize",
+    action="store",
+    type=int,
+    default=0,
+    help="RNTuple compressed cluster size in bytes. Use 0 for the default.",
+)
+parser.add_argument(
+    "--compression",
+    dest="compression",
+    action="store",
+    type=int,
+    default=-1,
+    help="ROOT compression settings of the output branches, e.g. 505 for "
+    "ZSTD level 5. Use -1 for the settings of the output file.",
+)
+parser.add_argument(
+    "--histograms",
+    dest="histograms",
+    action="store_true",
+    default=False,
+    help="Fill the per-channel phiCP histograms in the job.",
+)
+parser.add_argument(
+    "--fourier-moments",
+    dest="fourierMoments",
+    action="store_true",
+    default=False,
+    help="Estimate the CP phase of every channel from Fourier moments.",
+)
+parser.add_argument(
+    "--bootstrap",
+    dest="bootstrap",
+    action="store",
+    type=int,
+    default=0,
+    help="Number of Poisson bootstrap replicas of the Fourier moments.",
+)
+parser.add_argument(
+    "--channels",
+    dest="channels",
+    action="store",
+    type=str,
+    default="",
+    help="Comma-separated decay channels to process, e.g. 1p0n_1p0n,lept_1p0n. "
+    "Needs the event index of the input files, see buildEventIndex. Other "
+    "entries are still looped over, but none of their containers is read and "
+    "--event-limit counts only the selected ones.",
+)
+parser.add_argument(
+    "--event-index-dir",
+    dest="eventIndexDir",
+    action="store",
+    type=str,
+    default="",
+    help="Directory of the event indices, as passed to buildEventIndex "
+    "--output-dir. Default: next to the input files.",
+)
+parser.add_argument(
+    "--variations",
+    dest="variations",
+    action="store",
+    type=str,
+    default="",
+    help="Comma-separated variations of the reconstructed phiCP, e.g. "
+    "truthtaus,pv_noshift. Each is written to a phiCP_recon_<variation> column.",
+)
+parser.add_argument(
+    "--access-mode",
+    dest="accessMode",
+    action="store",
+    choices=["class", "branch", "athena"],
+    default=None,
+    help="xAOD access mode of the input. branch only reads the auxiliary "
+    "variables that are used. Default: the EventLoop default.",
+)
+parser.add_argument(
+    "--cache-size",
+    dest="cacheSize",
+    action="store",
+    type=int,
+    default=None,
+    help="TTreeCache size of the input in bytes. The cache prefetches the "
+    "branches read during the learning phase. Default: the EventLoop default.",
+)
+parser.add_argument(
+    "--cache-learn-entries",
+    dest="cacheLearnEntries",
+    action="store",
+    type=int,
+    default=None,
+    help="Number of entries the TTreeCache learns the used branches from.",
+)
+parser.add_argument(
+    "--io-stats",
+    dest="ioStats",
+    action="store_true",
+    default=False,
+    help="Collect the xAOD read statistics and print the bytes read, read "
+    "calls and decompression time of every input container.",
+)
+parser.add_argument(
+    "--time-stages",
+    dest="timeStages",
+    action="store_true",
+    default=False,
+    help="Time the processing stages of every event per channel.",
 )
 parser.add_argument(
     "-d",
@@ -45,6 +210,16 @@ parser.add_argument(
 )
 options = parser.parse_args()
 
+# Samples, and hence their output files, are named after their directories,
+# so two directories with the same name would overwrite each other's output
+sampleNames = [os.path.basename(os.path.normpath(p)) for p in options.configPaths]
+duplicates = sorted({name for name in sampleNames if sampleNames.count(name) > 1})
+if duplicates:
+    parser.error(
+        "Sample directories must have distinct names, repeated: "
+        + ", ".join(duplicates)
+    )
+
 # Set up (Py)ROOT.
 import ROOT
 
@@ -57,11 +232,17 @@ sh = ROOT.SH.SampleHandler()
 # containing the EDM containers is "CollectionTree"
 sh.setMetaString("nc_tree", "CollectionTree")
 
-# Use SampleHandler to get the sample from the defined location
-sample = ROOT.SH.SampleLocal("dataset")
-for filename in os.listdir(options.configPath):
-    sample.add(os.path.join(options.configPath, filename))
-sh.add(sample)
+# Use SampleHandler to get one sample per directory. The files are sorted so
+# that the split into workers, and hence the merged output, is the same on
+# every run.
+for configPath, sampleName in zip(options.configPaths, sampleNames):
+    sample = ROOT.SH.SampleLocal(sampleName)
+    for filename in sorted(os.listdir(configPath)):
+        # Event index sidecars are not inputs
+        if filename.endswith(".eventindex.root"):
+            continue
+        sample.add(os.path.join(configPath, filename))
+    sh.add(sample)
 
 # Print information about the sample
 sh.printContent()
@@ -69,9 +250,29 @@ sh.printContent()
 # Create an EventLoop job.
 job = ROOT.EL.Job()
 job.sampleHandler(sh)
-job.options().setDouble(ROOT.EL.Job.optMaxEvents, options.eventLimit)
+if not options.channels:
+    job.options().setDouble(ROOT.EL.Job.optMaxEvents, options.eventLimit)
 job.options().setString(ROOT.EL.Job.optSubmitDirMode, "unique-link")
 
+# Input read path
+if options.accessMode is not None:
+    accessModes = {
+        "class": ROOT.EL.Job.optXaodAccessMode_class,
+        "branch": ROOT.EL.Job.optXaodAccessMode_branch,
+        "athena": ROOT.EL.Job.optXaodAccessMode_athena,
+    }
+    job.options().setString(
+        ROOT.EL.Job.optXaodAccessMode, accessModes[options.accessMode]
+    )
+if options.cacheSize is not None:
+    job.options().setDouble(ROOT.EL.Job.optCacheSize, options.cacheSize)
+if options.cacheLearnEntries is not None:
+    job.options().setDouble(
+        ROOT.EL.Job.optCacheLearnEntries, options.cacheLearnEntries
+    )
+if options.ioStats:
+    job.options().setBool(ROOT.EL.Job.optXAODPerfStats, True)
+
 # Create the algorithm's configuration.
 from AnaAlgorithm.DualUseConfig import createAlgorithm
 
@@ -81,6 +282,29 @@ alg = createAlgorithm("TruthLevelAnalysis", "AnalysisAlg")
 if options.debug:
     alg.OutputLevel = ROOT.MSG.DEBUG
 
+# Output layout and storage settings
+alg.OutputFormat = options.outputFormat
+alg.OutputLayout = options.outputLayout
+alg.BasketSize = options.basketSize
+alg.PageSize = options.pageSize
+alg.ClusterSize = options.clusterSize
+alg.Compression = options.compression
+
+# Histograms filled in the job, merged with the outputs of parallel workers
+alg.FillHistograms = options.histograms
+alg.FillFourierMoments = options.fourierMoments
+alg.BootstrapReplicas = options.bootstrap
+
+# Only the entries of these channels are read. EventLoop still loops over
+# the others, so the algorithm counts the selected ones against the limit.
+alg.Channels = options.channels
+if options.channels:
+    alg.EventLimit = options.eventLimit
+alg.EventIndexDir = options.eventIndexDir
+alg.Variations = options.variations
+alg.PrintReadStats = options.ioStats
+alg.TimeStages = options.timeStages
+
 # Add our algorithm to the job
 job.algsAdd(alg)
 
@@ -89,8 +313,23 @@ job.algsAdd(alg)
 # Add output stream
 job.outputAdd(ROOT.EL.OutputStream("ANALYSIS"))
 
-# Run the job using the direct driver.
-driver = ROOT.EL.DirectDriver()
+if options.jobs > 1 and options.eventLimit >= 0:
+    # Every worker would process up to the limit from its own segment
+    print(
+        "The event limit counts per sample only in a sequential job, "
+        "ignoring --jobs %d" % options.jobs
+    )
+if options.jobs > 1 and options.eventLimit < 0:
+    # Run the job in parallel local processes, which take the segments of all
+    # samples from one queue. EventLoop merges the outputs of the workers in
+    # the order of their segments, so the merged trees and histograms do not
+    # depend on which worker finished first.
+    job.options().setDouble(ROOT.EL.Job.optFilesPerWorker, options.filesPerWorker)
+    driver = ROOT.EL.LocalDriver()
+    driver.options().setInteger(ROOT.EL.Job.optNumParallelProcs, options.jobs)
+else:
+    # Run the job using the direct driver, one sample after the other.
+    driver = ROOT.EL.DirectDriver()
 driver.submit(job, options.submitDir)
 
 # Do not add anything here!!!
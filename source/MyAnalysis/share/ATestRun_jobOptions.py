@@ -57,11 +57,19 @@ svcMgr.THistSvc.MaxFileSize = -1  # speeds up jobs that output lots of histogram
 # We need to explicitly instantiate CutFlowSvc in Athena
 
 
-# Create the algorithm's configuration.
+# Create the algorithm's configuration. The reentrant version runs
+# multi-threaded with: athena --threads=N ATestRun_jobOptions.py
+from AnaAlgorithm.DualUseConfig import createAlgorithm
 
+alg = createAlgorithm("TruthLevelAnalysisMT", "AnalysisAlg")
 
-# Add our algorithm to the main alg sequence
+# Read the BSM Higgs only if the input has it. The scheduler needs a producer
+# for every key, so a missing container would stop the job.
+if "TruthBSMWithDecayParticles" in flags.Input.Collections:
+    alg.TruthBSM = "TruthBSMWithDecayParticles"
 
+# Add our algorithm to the main alg sequence
+athAlgSeq += alg
 
 # Add all algorithms from the sequence to the job.
 
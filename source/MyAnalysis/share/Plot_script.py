@@ -1,7 +1,7 @@
 #!/usr/bin/env python3
 
 import inquirer
-from Run_script import SAMPLES
+from Run_script import SAMPLES, output_path
 import math
 import re
 
@@ -59,32 +59,24 @@ print("Loading ntuples...")
 
 import ROOT
 import os
+from MyAnalysis.TauAnalysisTree import Ntuple
 
-files = [
-    ROOT.TFile.Open(f"/srv/run/{SAMPLES[sample]}/data-ANALYSIS/dataset.root")
-    for sample in samples
-]
-trees = [file.Get("tau_analysis") for file in files]
+paths = {sample: output_path(SAMPLES[sample]) for sample in samples}
 
+# Each ntuple is a TTree or an RNTuple, depending on the job's OutputFormat
+trees = [Ntuple(paths[sample]) for sample in samples]
 
-branch_names = set()
-for tree in trees:
-    for branch in tree.GetListOfBranches():
-        branch_name = branch.GetName()
-        valid = False
-        for entry in tree:
-            value = getattr(entry, branch_name)
-            if value is None:
-                continue
-            if "lower" in locals() and value < lower:
-                continue
-            if "upper" in locals() and value > upper:
-                continue
-            valid = True
-            break
-        if not valid:
-            continue
-        branch_names.add(branch_name)
+# Compiled backend, fills all histograms of all samples in one multi-threaded
+# pass over the events
+ROOT.EnableImplicitMT()
+histogrammer = ROOT.NtupleHistogrammer()
+for sample in samples:
+    histogrammer.addSample(sample, paths[sample])
+
+if plot_mode in [HISTOGRAM_MODE, HISTOGRAM_FIT_MODE, HISTOGRAM_FIT_UNCERTAINTY_MODE]:
+    branch_names = list(histogrammer.branchesInRange(lower, upper))
+else:
+    branch_names = list(histogrammer.branchesInRange(-math.inf, math.inf))
 
 branch_names = sorted(branch_names)
 
@@ -123,6 +115,9 @@ while True:
         float(upper_cut) if upper_cut else math.inf,
     )
 
+for cut_branch, (cut_lower, cut_upper) in cuts.items():
+    histogrammer.addCut(cut_branch, cut_lower, cut_upper)
+
 
 histograms = {}
 heatmaps = {}
@@ -140,6 +135,7 @@ if plot_mode in [HISTOGRAM_MODE, HISTOGRAM_FIT_MODE, HISTOGRAM_FIT_UNCERTAINTY_M
     )
 
     # Original histogram mode
+    requested = []
     for tree, sample in zip(trees, samples):
         cp_nature, decay_mode, mass = re.match(
             r"^cp-(.+?)-(.+?)(?:-H(.+?))?$", SAMPLES[sample]
@@ -158,88 +154,80 @@ if plot_mode in [HISTOGRAM_MODE, HISTOGRAM_FIT_MODE, HISTOGRAM_FIT_UNCERTAINTY_M
             hist_title = hist_title_template.format(**args)
             hist_name = hist_name_template.format(**args)
 
-            hist = ROOT.TH1F(hist_name, hist_name, BINS, lower, upper)
-            hist.SetTitle(hist_title)
-
-            for entry in tree:
-                for cut_branch, (cut_lower, cut_upper) in cuts.items():
-                    cut_value = abs(getattr(entry, cut_branch))
-                    if cut_lower and cut_value < cut_lower:
-                        break
-                    if cut_upper and cut_value > cut_upper:
-                        break
-                else:  # Only proceed if all cuts are satisfied
-                    value = getattr(entry, branch)
-                    hist.Fill(value)
-
-            integral = hist.Integral()
-            if integral == 0:
-                print(
-                    f"Warning: Histogram '{hist_name}' has zero integral, skipping normalization."
-                )
+            # Use the histogram the job filled if it has the requested binning
+            stored = None if cuts else tree.histogram(branch)
+            if stored and stored.GetNbinsX() == BINS:
+                hist = stored.Clone(hist_name)
+                hist.SetDirectory(0)
             else:
-                print(
-                    f"Normalizing histogram '{hist_name}' with integral {integral:.0f}."
-                )
-                hist.Scale(scaling_factor / integral)  # Normalization
-            hist.SetLineWidth(1)
-            hist.SetStats(0)
-            histograms[hist_name] = hist
+                histogrammer.addHistogram(hist_name, branch, BINS, lower, upper)
+                hist = None
+            requested.append((sample, hist_name, hist_title, hist))
+
+    # Fill all histograms not stored in the ntuples in a single pass
+    if any(hist is None for _, _, _, hist in requested):
+        histogrammer.run()
+
+    for sample, hist_name, hist_title, hist in requested:
+        if hist is None:
+            hist = histogrammer.histogram(sample, hist_name).Clone(hist_name)
+            hist.SetDirectory(0)
+        hist.SetTitle(hist_title)
+
+        integral = hist.Integral()
+        if integral == 0:
+            print(
+                f"Warning: Histogram '{hist_name}' has zero integral, skipping normalization."
+            )
+        else:
+            print(f"Normalizing histogram '{hist_name}' with integral {integral:.0f}.")
+            hist.Scale(scaling_factor / integral)  # Normalization
+        hist.SetLineWidth(1)
+        hist.SetStats(0)
+        histograms[hist_name] = hist
 
 else:
     # X-Y heatmap mode (2D binning)
-    for tree, sample in zip(trees, samples):
-        x_values = []
-        y_values = []
-
-        for entry in tree:
-            # Apply cuts
-            cuts_satisfied = True
-            for cut_branch, (cut_lower, cut_upper) in cuts.items():
-                cut_value = abs(getattr(entry, cut_branch))
-                if cut_lower and cut_value < cut_lower:
-                    cuts_satisfied = False
-                    break
-                if cut_upper and cut_value > cut_upper:
-                    cuts_satisfied = False
-                    break
-
-            if cuts_satisfied:
-                x_val = getattr(entry, x_branch)
-                y_val = getattr(entry, y_branch)
-                if x_val is not None and y_val is not None:
-                    x_values.append(x_val)
-                    y_values.append(y_val)
-
-        if len(x_values) > 0:
-            # Use fixed ranges for both axes (0 to 2π)
-            x_min, x_max = 0.0, 2 * math.pi
-            y_min, y_max = 0.0, 2 * math.pi
-
-            heatmap_name = f"heatmap_{sample}"
-            heatmap_title = ""
-            # heatmap_title = (
-            # SAMPLES[sample]
-            # .replace("-hadhad", "")
-            # .replace("-hadlep", "")
-            # .replace("-lephad", "")
-            # )
-
-            # Create 2D histogram
-            heatmap = ROOT.TH2F(
-                heatmap_name, heatmap_title, BINS_X, x_min, x_max, BINS_Y, y_min, y_max
-            )
+    for sample in samples:
+        # Use fixed ranges for both axes (0 to 2π)
+        x_min, x_max = 0.0, 2 * math.pi
+        y_min, y_max = 0.0, 2 * math.pi
+
+        histogrammer.addHistogram2D(
+            f"heatmap_{sample}",
+            x_branch,
+            y_branch,
+            BINS_X,
+            x_min,
+            x_max,
+            BINS_Y,
+            y_min,
+            y_max,
+        )
+
+    histogrammer.run()
+
+    for sample in samples:
+        heatmap_name = f"heatmap_{sample}"
+        heatmap = histogrammer.histogram(sample, heatmap_name).Clone(heatmap_name)
+        heatmap.SetDirectory(0)
+        if heatmap.GetEntries() == 0:
+            continue
 
-            out_of_range_counter = 0
-            # Fill the 2D histogram
-            for x_val, y_val in zip(x_values, y_values):
-                heatmap.Fill(x_val, y_val)
+        heatmap_title = ""
+        # heatmap_title = (
+        # SAMPLES[sample]
+        # .replace("-hadhad", "")
+        # .replace("-hadlep", "")
+        # .replace("-lephad", "")
+        # )
+        heatmap.SetTitle(heatmap_title)
 
-            heatmap.SetStats(0)  # Disable statistics box
-            heatmaps[heatmap_name] = heatmap
+        heatmap.SetStats(0)  # Disable statistics box
+        heatmaps[heatmap_name] = heatmap
 
-            integral = heatmap.Integral()
-            print(f"2D heatmap with {BINS_X}x{BINS_Y} with integral {integral:.0f}")
+        integral = heatmap.Integral()
+        print(f"2D heatmap with {BINS_X}x{BINS_Y} with integral {integral:.0f}")
 
 # Define the fit function: y(x) = A*cos(B*x + C) + D (for histogram + fit modes)
 if plot_mode in [HISTOGRAM_FIT_MODE, HISTOGRAM_FIT_UNCERTAINTY_MODE]:
@@ -499,8 +487,8 @@ while os.path.exists(output_filename):
 # canvas.SetCanvasSize(1920, 1080)
 canvas.SaveAs(output_filename)
 
-for file in files:
-    file.Close()
+for tree in trees:
+    tree.Close()
 
 
 # Save fit results to a text file (for both fit modes)
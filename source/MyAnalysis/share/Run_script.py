@@ -1,6 +1,7 @@
 #!/usr/bin/env python3
 
 import inquirer
+import os
 import subprocess
 
 # - selection of samples using multi-select
@@ -19,6 +20,37 @@ SAMPLES = {
     "cp-even\thadhad\tH3000": "cp-even-hadhad-H3000",
 }
 
+# All selected samples run in one job with this submission directory, each
+# written to its own output file. EventLoop creates a new directory for every
+# run and points this link at it.
+SUBMIT_DIR = "/srv/run/analysis"
+
+# Links to the latest output of every sample, so samples processed in
+# different runs can be read together
+OUTPUT_DIR = "/srv/run/outputs"
+
+
+# Event indices of the inputs, kept out of the possibly read-only samples
+EVENT_INDEX_DIR = "/srv/run/eventindex"
+
+
+def output_path(sample_dir):
+    return f"{OUTPUT_DIR}/{sample_dir}.root"
+
+
+def link_outputs(sample_dirs):
+    """Points the output links of the samples at the run that just finished"""
+    run_dir = os.path.realpath(SUBMIT_DIR)
+    os.makedirs(OUTPUT_DIR, exist_ok=True)
+    for sample_dir in sample_dirs:
+        target = f"{run_dir}/data-ANALYSIS/{sample_dir}.root"
+        link = output_path(sample_dir)
+        if os.path.lexists(link + ".new"):
+            os.remove(link + ".new")
+        os.symlink(target, link + ".new")
+        os.replace(link + ".new", link)
+
+
 questions = [
     inquirer.Checkbox(
         "samples",
@@ -27,10 +59,24 @@ questions = [
     ),
     inquirer.Text(
         "events",
-        message="How many events do you want to process?",
+        message="How many events per sample? (-1 for all, in parallel)",
         default="100",
         validate=lambda _, x: x.isdigit() or x == "-1",
     ),
+    # An event limit counts per sample only in a sequential job, so workers
+    # are only asked for when processing all events
+    inquirer.Text(
+        "jobs",
+        message="How many worker processes, shared by all samples?",
+        default=str(os.cpu_count() or 1),
+        validate=lambda _, x: x.isdigit() and int(x) > 0,
+        ignore=lambda answers: answers["events"] != "-1",
+    ),
+    inquirer.Text(
+        "channels",
+        message="Which decay channels do you want to process? (empty for all)",
+        default="",
+    ),
     inquirer.Confirm(
         "debug",
         message="Do you want to run in debug mode?",
@@ -45,10 +91,29 @@ if __name__ == "__main__":
 
     subprocess.run(["make"], cwd="/srv/build")
 
-    for sample in answers["samples"]:
-        out = SAMPLES[sample]
-        dir = "/samples/" + out
-        cmd = ["ATestRun_eljob.py", "-c", dir, "-s", out, "-e", answers["events"]]
-        if debug:
-            cmd.append("--debug")
-        subprocess.run(cmd, cwd="/srv/run")
+    dirs = ["/samples/" + SAMPLES[sample] for sample in answers["samples"]]
+    if not dirs:
+        raise SystemExit("No samples selected.")
+
+    # A single job processes all samples, so the setup is only done once
+    cmd = ["ATestRun_eljob.py", "-c"] + dirs
+    cmd += ["-s", SUBMIT_DIR, "-e", answers["events"], "-j", answers["jobs"]]
+    if answers["channels"]:
+        # Index the truth decays of new inputs, later runs reuse it
+        inputs = [
+            os.path.join(dir, name)
+            for dir in dirs
+            for name in sorted(os.listdir(dir))
+            if not name.endswith(".eventindex.root")
+        ]
+        subprocess.run(
+            ["buildEventIndex", "--output-dir", EVENT_INDEX_DIR] + inputs,
+            cwd="/srv/run",
+        )
+        cmd += ["--channels", answers["channels"]]
+        cmd += ["--event-index-dir", EVENT_INDEX_DIR]
+    if debug:
+        cmd.append("--debug")
+    if subprocess.run(cmd, cwd="/srv/run").returncode != 0:
+        raise SystemExit("The job failed, the outputs of earlier runs are kept.")
+    link_outputs(SAMPLES[sample] for sample in answers["samples"])
@@ -0,0 +1,162 @@
+#include "AsgDataHandles/ReadHandle.h"
+#include "AsgMessaging/MessageCheck.h"
+#include "GaudiKernel/ConcurrencyFlags.h"
+#include "TruthLevelAnalysisMT.h"
+#include <TH1.h>
+#include <TTree.h>
+#include <algorithm>
+
+TruthLevelAnalysisMT::TruthLevelAnalysisMT(const std::string &name,
+                                           ISvcLocator *pSvcLocator)
+    : EL::AnaReentrantAlgorithm(name, pSvcLocator), m_processor(name) {}
+
+StatusCode TruthLevelAnalysisMT::initialize() {
+  m_processor.setLevel(msg().level());
+
+  ANA_CHECK(m_eventInfoKey.initialize());
+  ANA_CHECK(m_truthBSMKey.initialize(SG::AllowEmpty));
+  ANA_CHECK(m_truthBosonsKey.initialize());
+  ANA_CHECK(m_truthTausKey.initialize());
+  ANA_CHECK(m_tauJetsKey.initialize());
+  ANA_CHECK(m_electronsKey.initialize());
+  ANA_CHECK(m_muonsKey.initialize());
+  ANA_CHECK(m_verticesKey.initialize());
+
+  TauAnalysisWriter::Options options;
+  if (!parseOutputLayout(m_outputLayout, options.layout)) {
+    ANA_MSG_ERROR("Unknown output layout " << m_outputLayout.value());
+    return StatusCode::FAILURE;
+  }
+  options.basketSize = m_basketSize;
+  options.compression = m_compression;
+  // Serial athena reports no concurrent events but still uses slot 0
+  options.nSlots = std::max<std::size_t>(
+      Gaudi::Concurrency::ConcurrencyFlags::numConcurrentEvents(), 1);
+  options.bufferSize = m_bufferSize;
+
+  std::vector<PhiCPVariation> variations;
+  if (!parseVariationList(m_variations, variations)) {
+    ANA_MSG_ERROR("Invalid phiCP variations " << m_variations.value());
+    return StatusCode::FAILURE;
+  }
+  m_processor.setVariations(variations);
+  for (const PhiCPVariation &variation : variations) {
+    options.variations.push_back(variation.name);
+  }
+
+  // The tree is owned by THistSvc, which writes it to the ANALYSIS stream
+  ANA_CHECK(m_histSvc.retrieve());
+  TTree *tree = new TTree("tau_analysis", "tau analysis");
+  ANA_CHECK(m_histSvc->regTree("/ANALYSIS/tau_analysis", tree));
+
+  m_writer.attach(tree, options);
+
+  m_cutflows.resize(options.nSlots);
+  m_arenas = std::vector<EventArena>(options.nSlots);
+  for (int channel = CHANNEL_NONE + 1; channel <= CHANNEL_COUNT; channel++) {
+    std::string name =
+        channel == CHANNEL_COUNT
+            ? std::string("cutflow")
+            : std::string("cutflow_") +
+                  decayChannelName(static_cast<DecayChannel>(channel));
+    TH1 *hist = new TH1D(Cutflow::makeHistogram(name.c_str()));
+    ANA_CHECK(m_histSvc->regHist("/ANALYSIS/" + name, hist));
+    m_cutflowHists[channel] = hist;
+  }
+
+  return StatusCode::SUCCESS;
+}
+
+template <class T>
+StatusCode TruthLevelAnalysisMT::retrieve(const SG::ReadHandleKey<T> &key,
+                                          const EventContext &ctx,
+                                          const T *&container) const {
+  SG::ReadHandle<T> handle(key, ctx);
+  if (!handle.isValid()) {
+    ANA_MSG_ERROR("Failed to retrieve " << key.key());
+    return StatusCode::FAILURE;
+  }
+  container = handle.cptr();
+  return StatusCode::SUCCESS;
+}
+
+StatusCode TruthLevelAnalysisMT::execute(const EventContext &ctx) const {
+  TauPairEvent event;
+  ANA_CHECK(retrieve(m_truthTausKey, ctx, event.truthTaus));
+
+  if (!m_truthBSMKey.empty()) {
+    SG::ReadHandle<xAOD::TruthParticleContainer> truthBSM(m_truthBSMKey, ctx);
+    if (truthBSM.isValid() && !truthBSM->empty()) {
+      ANA_MSG_VERBOSE("Found BSM Higgs with decay products.");
+      event.truthHiggs = truthBSM.cptr();
+    }
+  }
+
+  if (event.truthHiggs == nullptr) {
+    ANA_MSG_VERBOSE("No BSM Higgs found, falling back to standard Higgs.");
+    ANA_CHECK(retrieve(m_truthBosonsKey, ctx, event.truthHiggs));
+  }
+
+  // Everything the event needs is local or on the arena of its slot, so
+  // concurrent events never share it
+  EventArena &arena = m_arenas[ctx.slot()];
+  arena.reset();
+  TruthDecayIndex truthDecays(&arena);
+  Cutflow &cutflow = m_cutflows[ctx.slot()];
+  Cut failedCut = CUT_COUNT;
+  unsigned containers = m_processor.classify(event, truthDecays, failedCut);
+  if (containers == RECO_NONE) {
+    cutflow.fail(CHANNEL_NONE, failedCut);
+    return StatusCode::SUCCESS;
+  }
+  const DecayChannel truthChannel = decayChannelOf(
+      truthDecays.tauNeg().decayMode, truthDecays.tauPos().decayMode);
+
+  // The reconstruction containers are read for the accepted events alone
+  if (containers & RECO_EVENT_INFO) {
+    ANA_CHECK(retrieve(m_eventInfoKey, ctx, event.eventInfo));
+  }
+  if (containers & RECO_VERTICES) {
+    ANA_CHECK(retrieve(m_verticesKey, ctx, event.vertices));
+  }
+  if (containers & RECO_TAU_JETS) {
+    ANA_CHECK(retrieve(m_tauJetsKey, ctx, event.tauJets));
+  }
+  if (containers & RECO_ELECTRONS) {
+    ANA_CHECK(retrieve(m_electronsKey, ctx, event.electrons));
+  }
+  if (containers & RECO_MUONS) {
+    ANA_CHECK(retrieve(m_muonsKey, ctx, event.muons));
+  }
+
+  TauAnalysisRecord record;
+  if (m_processor.process(event, truthDecays, record, failedCut)) {
+    cutflow.pass(truthChannel);
+    m_writer.write(ctx.slot(), record);
+  } else {
+    cutflow.fail(truthChannel, failedCut);
+  }
+
+  return StatusCode::SUCCESS;
+}
+
+StatusCode TruthLevelAnalysisMT::finalize() {
+  m_writer.close();
+
+  Cutflow cutflow;
+  for (const Cutflow &slotCutflow : m_cutflows) {
+    cutflow.merge(slotCutflow);
+  }
+  for (int channel = CHANNEL_NONE + 1; channel <= CHANNEL_COUNT; channel++) {
+    cutflow.store(static_cast<DecayChannel>(channel), *m_cutflowHists[channel]);
+  }
+  ANA_MSG_INFO("Cutflow:\n" << cutflow.table());
+
+  ArenaStats arenaStats;
+  for (EventArena &arena : m_arenas) {
+    arena.flushStats();
+    arenaStats.merge(arena.stats());
+  }
+  ANA_MSG_INFO("Event arenas: " << arenaStats.summary());
+  return StatusCode::SUCCESS;
+}
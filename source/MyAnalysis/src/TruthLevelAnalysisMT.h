@@ -0,0 +1,94 @@
+#ifndef MyAnalysis_TruthLevelAnalysisMT_H
+#define MyAnalysis_TruthLevelAnalysisMT_H
+
+#include "AsgDataHandles/ReadHandleKey.h"
+#include "CxxUtils/checker_macros.h"
+#include "GaudiKernel/ITHistSvc.h"
+#include "GaudiKernel/ServiceHandle.h"
+#include <AnaAlgorithm/AnaReentrantAlgorithm.h>
+#include <MyAnalysis/Cutflow.h>
+#include <MyAnalysis/EventArena.h>
+#include <MyAnalysis/TauAnalysisWriter.h>
+#include <MyAnalysis/TauPairProcessor.h>
+#include <vector>
+
+class TH1;
+
+/**
+ * Reentrant version of TruthLevelAnalysis for AthenaMT.
+ *
+ * Per-event state is local to execute() or on the arena of the event slot,
+ * the containers are read through handle keys and the records go through a
+ * writer with one buffer per event slot. Run it with e.g.
+ * athena --threads=64 ATestRun_jobOptions.py.
+ */
+class TruthLevelAnalysisMT : public EL::AnaReentrantAlgorithm {
+public:
+  TruthLevelAnalysisMT(const std::string &name, ISvcLocator *pSvcLocator);
+
+  virtual StatusCode initialize() override;
+  virtual StatusCode execute(const EventContext &ctx) const override;
+  virtual StatusCode finalize() override;
+
+private:
+  /* Reads the container of the key, failing if it is not in the store */
+  template <class T>
+  StatusCode retrieve(const SG::ReadHandleKey<T> &key, const EventContext &ctx,
+                      const T *&container) const;
+
+  SG::ReadHandleKey<xAOD::EventInfo> m_eventInfoKey{
+      this, "EventInfo", "EventInfo", "Event information"};
+  SG::ReadHandleKey<xAOD::TruthParticleContainer> m_truthBSMKey{
+      this, "TruthBSM", "",
+      "BSM Higgs with decay products (TruthBSMWithDecayParticles), only set "
+      "if the input has it"};
+  SG::ReadHandleKey<xAOD::TruthParticleContainer> m_truthBosonsKey{
+      this, "TruthBosons", "TruthBosonsWithDecayParticles",
+      "Standard Higgs with decay products"};
+  SG::ReadHandleKey<xAOD::TruthParticleContainer> m_truthTausKey{
+      this, "TruthTaus", "TruthTausWithDecayParticles",
+      "Truth taus with decay products"};
+  SG::ReadHandleKey<xAOD::TauJetContainer> m_tauJetsKey{
+      this, "TauJets", "TauJets", "Reconstructed tau jets"};
+  SG::ReadHandleKey<xAOD::ElectronContainer> m_electronsKey{
+      this, "Electrons", "Electrons", "Reconstructed electrons"};
+  SG::ReadHandleKey<xAOD::MuonContainer> m_muonsKey{
+      this, "Muons", "Muons", "Reconstructed muons"};
+  SG::ReadHandleKey<xAOD::VertexContainer> m_verticesKey{
+      this, "PrimaryVertices", "PrimaryVertices", "Reconstructed vertices"};
+
+  Gaudi::Property<std::string> m_outputLayout{
+      this, "OutputLayout", "wide",
+      "Branch layout of the tau_analysis tree, wide or compact"};
+  Gaudi::Property<int> m_basketSize{
+      this, "BasketSize", 0,
+      "Basket size of the output branches, 0 for the default"};
+  Gaudi::Property<int> m_compression{
+      this, "Compression", -1,
+      "ROOT compression settings of the output branches, -1 to use the "
+      "settings of the output file"};
+  Gaudi::Property<unsigned int> m_bufferSize{
+      this, "BufferSize", 1024,
+      "Number of records each event slot buffers before writing them"};
+  Gaudi::Property<std::string> m_variations{
+      this, "Variations", "",
+      "Comma-separated variations of the reconstructed phiCP, e.g. "
+      "truthtaus,pv_noshift, each written to a phiCP_recon_<variation> "
+      "column. See PhiCPVariation.h"};
+
+  ServiceHandle<ITHistSvc> m_histSvc{"THistSvc", name()};
+
+  TauPairProcessor m_processor;
+
+  /* Each slot only touches its own buffer, filling the tree is locked */
+  mutable TauAnalysisWriter m_writer ATLAS_THREAD_SAFE;
+
+  /* One cutflow per slot, merged in finalize */
+  mutable std::vector<Cutflow> m_cutflows ATLAS_THREAD_SAFE;
+
+  /* Transient containers of the event each slot is processing */
+  mutable std::vector<EventArena> m_arenas ATLAS_THREAD_SAFE;
+  TH1 *m_cutflowHists[CHANNEL_COUNT + 1] = {};
+};
+
+#endif
@@ -1,3 +1,5 @@
+#include "../TruthLevelAnalysisMT.h"
 #include <MyAnalysis/TruthLevelAnalysis.h>
 
-DECLARE_COMPONENT(TruthLevelAnalysis)
\ No newline at end of file
+DECLARE_COMPONENT(TruthLevelAnalysis)
+DECLARE_COMPONENT(TruthLevelAnalysisMT)
@@ -0,0 +1,37 @@
+#ifndef MyAnalysis_Check_H
+#define MyAnalysis_Check_H
+
+#include <cmath>
+#include <cstdio>
+
+/**
+ * Minimal checks of the unit tests in this directory. A failed check prints
+ * its location and expression; the test returns checkStatus() from main, so
+ * CTest reports it as failed.
+ */
+inline int &checkFailures() {
+  static int failures = 0;
+  return failures;
+}
+
+inline bool checkFailed(const char *file, int line, const char *expression) {
+  std::printf("%s:%d: check failed: %s\n", file, line, expression);
+  checkFailures()++;
+  return false;
+}
+
+inline int checkStatus() {
+  if (checkFailures() > 0) {
+    std::printf("%d checks failed\n", checkFailures());
+    return 1;
+  }
+  return 0;
+}
+
+#define CHECK(condition)                                                       \
+  ((condition) ? true : checkFailed(__FILE__, __LINE__, #condition))
+
+/* a and b agree to within the absolute tolerance */
+#define CHECK_CLOSE(a, b, tolerance) CHECK(std::abs((a) - (b)) <= (tolerance))
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ * Unit test of parseChannelList, the channel filter of TruthLevelAnalysis.
+ */
+
+#include "Check.h"
+#include <MyAnalysis/Utils.h>
+#include <string>
+
+namespace {
+
+int countSelected(const bool selected[CHANNEL_COUNT]) {
+  int count = 0;
+  for (int channel = 0; channel < CHANNEL_COUNT; channel++) {
+    count += selected[channel];
+  }
+  return count;
+}
+
+void testValidLists() {
+  bool selected[CHANNEL_COUNT];
+  CHECK(parseChannelList("1p0n_1p0n,lept_1p0n", selected));
+  CHECK(selected[CHANNEL_1P0N_1P0N]);
+  CHECK(selected[CHANNEL_LEPT_1P0N]);
+  CHECK(countSelected(selected) == 2);
+
+  // A name given twice selects its channel once
+  CHECK(parseChannelList("1p1n_1pXn,1p1n_1pXn", selected));
+  CHECK(selected[CHANNEL_1P1N_1PXN]);
+  CHECK(countSelected(selected) == 1);
+
+  // Every channel by its own name, and no flag left over from before
+  for (int channel = CHANNEL_NONE + 1; channel < CHANNEL_COUNT; channel++) {
+    CHECK(parseChannelList(
+        decayChannelName(static_cast<DecayChannel>(channel)), selected));
+    CHECK(selected[channel]);
+    CHECK(countSelected(selected) == 1);
+  }
+}
+
+void testInvalidLists() {
+  bool selected[CHANNEL_COUNT];
+  CHECK(!parseChannelList("1p0n_1p0n,3p0n_3p0n", selected));
+  CHECK(!parseChannelList("none", selected));
+  CHECK(!parseChannelList("1P0N_1P0N", selected));
+  CHECK(!parseChannelList("", selected));
+  CHECK(!parseChannelList("1p0n_1p0n,", selected));
+  CHECK(!parseChannelList("1p0n_1p0n,,lept_1p0n", selected));
+  CHECK(!parseChannelList(" 1p0n_1p0n", selected));
+}
+
+} // namespace
+
+int main() {
+  testValidLists();
+  testInvalidLists();
+  return checkStatus();
+}
@@ -0,0 +1,87 @@
+/**
+ * Unit test of Cutflow: the cumulative counts per channel and in total, the
+ * merge of cutflows and the table.
+ */
+
+#include "Check.h"
+#include <MyAnalysis/Cutflow.h>
+#include <string>
+
+namespace {
+
+/*
+ * 10 events in 1p0n_1p0n: 2 fail the primary vertex, 3 the tau jets and 5
+ * pass. 4 events without a tau pair count to channel none.
+ */
+Cutflow exampleCutflow() {
+  Cutflow cutflow;
+  for (int i = 0; i < 2; i++) {
+    cutflow.fail(CHANNEL_1P0N_1P0N, CUT_PRIMARY_VERTEX);
+  }
+  for (int i = 0; i < 3; i++) {
+    cutflow.fail(CHANNEL_1P0N_1P0N, CUT_TAU_JETS);
+  }
+  for (int i = 0; i < 5; i++) {
+    cutflow.pass(CHANNEL_1P0N_1P0N);
+  }
+  for (int i = 0; i < 4; i++) {
+    cutflow.fail(CHANNEL_NONE, CUT_TAU_PAIR);
+  }
+  return cutflow;
+}
+
+void testCumulativeCounts() {
+  Cutflow cutflow = exampleCutflow();
+  CHECK(cutflow.events(CHANNEL_1P0N_1P0N) == 10);
+  CHECK(cutflow.passed(CHANNEL_1P0N_1P0N, CUT_HIGGS) == 10);
+  CHECK(cutflow.passed(CHANNEL_1P0N_1P0N, CUT_CHANNEL) == 10);
+  CHECK(cutflow.passed(CHANNEL_1P0N_1P0N, CUT_PRIMARY_VERTEX) == 8);
+  CHECK(cutflow.passed(CHANNEL_1P0N_1P0N, CUT_TAU_JETS) == 5);
+  CHECK(cutflow.passed(CHANNEL_1P0N_1P0N, CUT_LEPTON) == 5);
+
+  CHECK(cutflow.events(CHANNEL_NONE) == 4);
+  CHECK(cutflow.passed(CHANNEL_NONE, CUT_HIGGS) == 4);
+  CHECK(cutflow.passed(CHANNEL_NONE, CUT_TAU_PAIR) == 0);
+
+  CHECK(cutflow.events(CHANNEL_LEPT_1P0N) == 0);
+  CHECK(cutflow.passed(CHANNEL_LEPT_1P0N, CUT_HIGGS) == 0);
+
+  // All channels together
+  CHECK(cutflow.events(CHANNEL_COUNT) == 14);
+  CHECK(cutflow.passed(CHANNEL_COUNT, CUT_TAU_PAIR) == 10);
+  CHECK(cutflow.passed(CHANNEL_COUNT, CUT_TAU_JETS) == 5);
+
+  // Counts never grow along the cuts
+  for (int cut = 1; cut < CUT_COUNT; cut++) {
+    CHECK(cutflow.passed(CHANNEL_COUNT, static_cast<Cut>(cut)) <=
+          cutflow.passed(CHANNEL_COUNT, static_cast<Cut>(cut - 1)));
+  }
+}
+
+void testMerge() {
+  Cutflow cutflow = exampleCutflow();
+  cutflow.merge(exampleCutflow());
+  CHECK(cutflow.events(CHANNEL_COUNT) == 28);
+  CHECK(cutflow.passed(CHANNEL_1P0N_1P0N, CUT_PRIMARY_VERTEX) == 16);
+  CHECK(cutflow.passed(CHANNEL_1P0N_1P0N, CUT_LEPTON) == 10);
+}
+
+void testTable() {
+  std::string table = exampleCutflow().table();
+  CHECK(table.rfind("all channels:\n", 0) == 0);
+  CHECK(table.find("1p0n_1p0n:\n") != std::string::npos);
+  // Channels without events are left out
+  CHECK(table.find("lept_1p0n") == std::string::npos);
+  // 5 of the 8 events passing the primary vertex pass the tau jets
+  CHECK(table.find("  tauJets                     5   62.50%   50.00%\n") !=
+        std::string::npos);
+}
+
+} // namespace
+
+int main() {
+  testCumulativeCounts();
+  testMerge();
+  testTable();
+  return checkStatus();
+}
@@ -0,0 +1,96 @@
+/**
+ * Unit test of EventArena: allocations from the buffer, the overflow to the
+ * heap, the growth at the next event and the stats including the last event.
+ */
+
+#include "Check.h"
+#include <MyAnalysis/EventArena.h>
+#include <cstdint>
+
+namespace {
+
+void testBufferAllocations() {
+  EventArena arena(256);
+  arena.reset();
+  void *first = arena.allocate(64, 8);
+  void *second = arena.allocate(32, 32);
+  CHECK(reinterpret_cast<std::uintptr_t>(second) % 32 == 0);
+  CHECK(second != first);
+  arena.flushStats();
+
+  const ArenaStats &stats = arena.stats();
+  CHECK(stats.events == 1);
+  CHECK(stats.allocations == 2);
+  CHECK(stats.bytes == 96);
+  CHECK(stats.heapAllocations == 0);
+  CHECK(stats.heapEvents == 0);
+  CHECK(stats.peakBytes >= 96 && stats.peakBytes <= 96 + 32);
+
+  // The next event starts from the beginning of the buffer
+  arena.reset();
+  CHECK(arena.allocate(64, 8) == first);
+}
+
+void testOverflow() {
+  EventArena arena(64);
+  arena.reset();
+  CHECK(arena.allocate(48, 8) != nullptr);
+  CHECK(arena.allocate(100, 8) != nullptr);
+  CHECK(arena.stats().heapAllocations == 1);
+  CHECK(arena.stats().heapBytes == 100);
+
+  // The overflowing event grows the buffer, so the same event fits next time
+  arena.reset();
+  CHECK(arena.capacity() >= 48 + 100);
+  CHECK(arena.allocate(48, 8) != nullptr);
+  CHECK(arena.allocate(100, 8) != nullptr);
+  CHECK(arena.stats().heapAllocations == 1);
+  arena.flushStats();
+  CHECK(arena.stats().heapEvents == 1);
+}
+
+void testLastEventStats() {
+  EventArena arena(64);
+  arena.reset();
+  CHECK(arena.allocate(16, 8) != nullptr);
+  arena.reset();
+  CHECK(arena.allocate(200, 8) != nullptr);
+
+  // Only the first event is in the stats until flushStats() or reset()
+  CHECK(arena.stats().heapEvents == 0);
+  CHECK(arena.stats().peakBytes == 16);
+  arena.flushStats();
+  CHECK(arena.stats().events == 2);
+  CHECK(arena.stats().heapEvents == 1);
+  CHECK(arena.stats().peakBytes == 200);
+
+  // Flushing again or resetting afterwards does not count the event twice
+  arena.flushStats();
+  arena.reset();
+  arena.flushStats();
+  CHECK(arena.stats().events == 3);
+  CHECK(arena.stats().heapEvents == 1);
+}
+
+void testMerge() {
+  ArenaStats a, b;
+  a.events = 2;
+  a.peakBytes = 10;
+  a.heapEvents = 1;
+  b.events = 3;
+  b.peakBytes = 30;
+  a.merge(b);
+  CHECK(a.events == 5);
+  CHECK(a.peakBytes == 30);
+  CHECK(a.heapEvents == 1);
+}
+
+} // namespace
+
+int main() {
+  testBufferAllocations();
+  testOverflow();
+  testLastEventStats();
+  testMerge();
+  return checkStatus();
+}
@@ -0,0 +1,139 @@
+/**
+ * Unit test of FourierMoments: the estimate on exactly known distributions,
+ * the variances against a direct computation and the merge of accumulators.
+ */
+
+#include "Check.h"
+#include <MyAnalysis/FourierMoments.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+/*
+ * Accumulator of N phi equally spaced over [0, 2 pi), weighted by
+ * 1 + A cos(phi + C). The first moments of the grid are exact, so the
+ * estimate is A and C up to rounding.
+ */
+FourierMoments gridDistribution(double amplitude, double phase) {
+  const int N = 360;
+  FourierMoments moments;
+  for (int k = 0; k < N; k++) {
+    double phi = 2 * M_PI * k / N;
+    moments.add(phi, 1 + amplitude * std::cos(phi + phase));
+  }
+  return moments;
+}
+
+void testEmpty() {
+  FourierMomentResult result = FourierMoments().result();
+  CHECK(result.sumWeights == 0.0);
+  CHECK(result.amplitude == 0.0);
+  CHECK(result.phase == 0.0);
+  CHECK(result.amplitudeVariance == 0.0);
+  CHECK(result.phaseVariance == 0.0);
+}
+
+void testKnownDistribution() {
+  FourierMomentResult result = gridDistribution(0.6, 1.2).result();
+  CHECK_CLOSE(result.sumWeights, 360.0, 1e-9);
+  CHECK_CLOSE(result.amplitude, 0.6, 1e-12);
+  CHECK_CLOSE(result.phase, 1.2, 1e-12);
+
+  // A phase above pi comes out of atan2 negative and is wrapped
+  result = gridDistribution(0.3, 5.0).result();
+  CHECK_CLOSE(result.amplitude, 0.3, 1e-12);
+  CHECK_CLOSE(result.phase, 5.0, 1e-12);
+
+  result = gridDistribution(0.0, 0.0).result();
+  CHECK_CLOSE(result.amplitude, 0.0, 1e-12);
+}
+
+void testVariances() {
+  std::mt19937_64 generator(12345);
+  std::uniform_real_distribution<double> phiDistribution(0.0, 2 * M_PI);
+  std::uniform_real_distribution<double> weightDistribution(0.5, 1.5);
+
+  std::vector<double> phis, weights;
+  FourierMoments moments;
+  for (int i = 0; i < 2000; i++) {
+    double phi = phiDistribution(generator);
+    // Some modulation, so the amplitude is far from zero
+    double weight = weightDistribution(generator) * (1 + 0.5 * std::cos(phi));
+    phis.push_back(phi);
+    weights.push_back(weight);
+    moments.add(phi, weight);
+  }
+
+  // Weighted means of cos and sin and their covariance, event by event
+  double sumW = 0, meanCos = 0, meanSin = 0;
+  for (std::size_t i = 0; i < phis.size(); i++) {
+    sumW += weights[i];
+    meanCos += weights[i] * std::cos(phis[i]);
+    meanSin += weights[i] * std::sin(phis[i]);
+  }
+  meanCos /= sumW;
+  meanSin /= sumW;
+  double varCos = 0, varSin = 0, covCosSin = 0;
+  for (std::size_t i = 0; i < phis.size(); i++) {
+    double dCos = std::cos(phis[i]) - meanCos;
+    double dSin = std::sin(phis[i]) - meanSin;
+    double w2 = weights[i] * weights[i];
+    varCos += w2 * dCos * dCos;
+    varSin += w2 * dSin * dSin;
+    covCosSin += w2 * dCos * dSin;
+  }
+  varCos /= sumW * sumW;
+  varSin /= sumW * sumW;
+  covCosSin /= sumW * sumW;
+
+  // Propagated to A = hypot(a, b) and C = atan2(b, a) with a = 2 <cos> and
+  // b = -2 <sin>, the derivatives taken numerically
+  double a = 2 * meanCos, b = -2 * meanSin;
+  double varA = 4 * varCos, varB = 4 * varSin, covAB = -4 * covCosSin;
+  const double h = 1e-6;
+  double dAda = (std::hypot(a + h, b) - std::hypot(a - h, b)) / (2 * h);
+  double dAdb = (std::hypot(a, b + h) - std::hypot(a, b - h)) / (2 * h);
+  double dCda = (std::atan2(b, a + h) - std::atan2(b, a - h)) / (2 * h);
+  double dCdb = (std::atan2(b + h, a) - std::atan2(b - h, a)) / (2 * h);
+  double amplitudeVariance =
+      dAda * dAda * varA + 2 * dAda * dAdb * covAB + dAdb * dAdb * varB;
+  double phaseVariance =
+      dCda * dCda * varA + 2 * dCda * dCdb * covAB + dCdb * dCdb * varB;
+  double covariance = dAda * dCda * varA +
+                      (dAda * dCdb + dAdb * dCda) * covAB + dAdb * dCdb * varB;
+
+  FourierMomentResult result = moments.result();
+  CHECK_CLOSE(result.sumWeights, sumW, 1e-9);
+  CHECK_CLOSE(result.amplitude, std::hypot(a, b), 1e-12);
+  CHECK_CLOSE(result.amplitudeVariance, amplitudeVariance,
+              1e-6 * amplitudeVariance);
+  CHECK_CLOSE(result.phaseVariance, phaseVariance, 1e-6 * phaseVariance);
+  CHECK_CLOSE(result.amplitudePhaseCovariance, covariance,
+              1e-6 * std::sqrt(amplitudeVariance * phaseVariance));
+}
+
+void testMerge() {
+  FourierMoments all, first, second;
+  for (int i = 0; i < 100; i++) {
+    double phi = 0.1 * i, weight = 1 + 0.01 * i;
+    all.add(phi, weight);
+    (i % 2 == 0 ? first : second).add(phi, weight);
+  }
+  first.merge(second);
+  for (int s = 0; s < FourierMoments::SUM_COUNT; s++) {
+    FourierMoments::Sum sum = static_cast<FourierMoments::Sum>(s);
+    CHECK_CLOSE(first.sum(sum), all.sum(sum), 1e-9);
+  }
+}
+
+} // namespace
+
+int main() {
+  testEmpty();
+  testKnownDistribution();
+  testVariances();
+  testMerge();
+  return checkStatus();
+}
@@ -0,0 +1,84 @@
+/**
+ * Unit test of parseVariationList: the settings of each name and the
+ * rejection of unknown, conflicting, duplicate and too many variations.
+ */
+
+#include "Check.h"
+#include <MyAnalysis/PhiCPVariation.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+void testSettings() {
+  std::vector<PhiCPVariation> variations;
+  CHECK(parseVariationList("", variations));
+  CHECK(variations.empty());
+
+  CHECK(parseVariationList("truthtaus_pv,visible_noshift,candidates",
+                           variations));
+  CHECK(variations.size() == 3);
+  if (variations.size() == 3) {
+    CHECK(variations[0].name == "truthtaus_pv");
+    CHECK(variations[0].frame == FRAME_TRUTH_TAUS);
+    CHECK(variations[0].origin == ORIGIN_PRIMARY_VERTEX);
+    CHECK(variations[0].leptonicShift);
+
+    CHECK(variations[1].frame == FRAME_VISIBLE);
+    CHECK(variations[1].origin == ORIGIN_JET_VERTEX);
+    CHECK(!variations[1].leptonicShift);
+
+    CHECK(variations[2].frame == FRAME_CANDIDATES);
+  }
+
+  // Settings that differ only in their order are the same variation, but
+  // different settings of one kind are not
+  CHECK(parseVariationList("pv,jetvertex", variations));
+  CHECK(variations.size() == 2);
+}
+
+void testRejected() {
+  std::vector<PhiCPVariation> variations;
+  CHECK(!parseVariationList("pv,shifted", variations));
+  CHECK(!parseVariationList("PV", variations));
+  CHECK(!parseVariationList("pv,", variations));
+  CHECK(!parseVariationList("pv,,visible", variations));
+  CHECK(!parseVariationList("pv__visible", variations));
+
+  // Two settings of one kind in a name
+  CHECK(!parseVariationList("visible_candidates", variations));
+  CHECK(!parseVariationList("pv_jetvertex", variations));
+  CHECK(!parseVariationList("noshift_noshift", variations));
+  CHECK(!parseVariationList("pv_pv", variations));
+
+  // Two variations with the same settings
+  CHECK(!parseVariationList("pv,pv", variations));
+  CHECK(!parseVariationList("pv_noshift,noshift_pv", variations));
+}
+
+void testMaximum() {
+  // The three frames and noshift, each with both origins, are exactly
+  // MAX_PHICP_VARIATIONS distinct variations
+  const char *firsts[] = {"visible", "candidates", "truthtaus", "noshift"};
+  const char *origins[] = {"jetvertex", "pv"};
+  std::string list;
+  for (const char *first : firsts) {
+    for (const char *origin : origins) {
+      list += std::string(list.empty() ? "" : ",") + first + "_" + origin;
+    }
+  }
+
+  std::vector<PhiCPVariation> variations;
+  CHECK(parseVariationList(list, variations));
+  CHECK(variations.size() == MAX_PHICP_VARIATIONS);
+  CHECK(!parseVariationList(list + ",noshift_visible", variations));
+}
+
+} // namespace
+
+int main() {
+  testSettings();
+  testRejected();
+  testMaximum();
+  return checkStatus();
+}
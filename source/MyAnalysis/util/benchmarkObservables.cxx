@@ -0,0 +1,330 @@
+/**
+ * Microbenchmark of the observable kernels.
+ *
+ * Runs every phiCP method (scalar and batched), calculateImpactParameter,
+ * upsilon and the bootstrap replica update over a fixed set of synthetic
+ * events and prints the time per event and the throughput. The inputs come
+ * from a fixed seed, so numbers from different builds or machines are
+ * directly comparable. Afterwards the invariant phiCP kernels are
+ * cross-checked against the boosted ones, see PhiCPMethod. The exit status is
+ * 1 if they differ by more than the 1e-9 rad documented there.
+ *
+ * Usage: benchmarkObservables [nEvents] [nRepetitions]
+ */
+
+#include <MyAnalysis/BootstrapReplicas.h>
+#include <MyAnalysis/Observables.h>
+#include <MyAnalysis/Utils.h>
+#include <MyAnalysis/Vector.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const double PION_CHARGED_MASS = 0.13957;
+const double PION_NEUTRAL_MASS = 0.13498;
+
+struct ThreeVectorColumns {
+  std::vector<double> x, y, z;
+
+  explicit ThreeVectorColumns(std::size_t n) : x(n), y(n), z(n) {}
+
+  void set(std::size_t i, const Vec3D &v) {
+    x[i] = v.x;
+    y[i] = v.y;
+    z[i] = v.z;
+  }
+  Vec3D get(std::size_t i) const { return {x[i], y[i], z[i]}; }
+  ThreeVectorArrays arrays() const { return {x.data(), y.data(), z.data()}; }
+};
+
+struct FourMomentumColumns {
+  std::vector<double> px, py, pz, e;
+
+  explicit FourMomentumColumns(std::size_t n) : px(n), py(n), pz(n), e(n) {}
+
+  void set(std::size_t i, const Vec4D &p) {
+    px[i] = p.x;
+    py[i] = p.y;
+    pz[i] = p.z;
+    e[i] = p.t;
+  }
+  Vec4D get(std::size_t i) const { return {px[i], py[i], pz[i], e[i]}; }
+  FourMomentumArrays arrays() const {
+    return {px.data(), py.data(), pz.data(), e.data()};
+  }
+};
+
+/* Synthetic visible tau decay products of a H -> tau tau event */
+struct SyntheticEvents {
+  ThreeVectorColumns pionPosImpactParam, pionNegImpactParam;
+  FourMomentumColumns pionPosP4, pionNegP4, pionNeuPosP4, pionNeuNegP4;
+  FourMomentumColumns ipFrame, rhoFrame;
+
+  explicit SyntheticEvents(std::size_t n)
+      : pionPosImpactParam(n), pionNegImpactParam(n), pionPosP4(n),
+        pionNegP4(n), pionNeuPosP4(n), pionNeuNegP4(n), ipFrame(n),
+        rhoFrame(n) {
+    std::mt19937_64 rng(20240601);
+    std::uniform_real_distribution<double> momentum(-40.0, 40.0);
+    std::uniform_real_distribution<double> impactParam(-0.1, 0.1);
+
+    auto particle = [&](double mass) {
+      Vec3D p{momentum(rng), momentum(rng), momentum(rng)};
+      return Vec4D::from(p, std::sqrt(p.mag2() + mass * mass));
+    };
+
+    for (std::size_t i = 0; i < n; ++i) {
+      pionPosImpactParam.set(
+          i, {impactParam(rng), impactParam(rng), impactParam(rng)});
+      pionNegImpactParam.set(
+          i, {impactParam(rng), impactParam(rng), impactParam(rng)});
+      Vec4D pionPos = particle(PION_CHARGED_MASS);
+      Vec4D pionNeg = particle(PION_CHARGED_MASS);
+      Vec4D pionNeuPos = particle(PION_NEUTRAL_MASS);
+      Vec4D pionNeuNeg = particle(PION_NEUTRAL_MASS);
+      pionPosP4.set(i, pionPos);
+      pionNegP4.set(i, pionNeg);
+      pionNeuPosP4.set(i, pionNeuPos);
+      pionNeuNegP4.set(i, pionNeuNeg);
+      ipFrame.set(i, pionPos + pionNeg);
+      rhoFrame.set(i, pionPos + pionNeuPos + pionNeg + pionNeuNeg);
+    }
+  }
+};
+
+/**
+ * Runs the body over all events nRepetitions times and reports the fastest
+ * repetition. The checksum keeps the compiler from dropping the work.
+ */
+template <typename Body>
+void measure(const std::string &name, std::size_t nEvents, int nRepetitions,
+             std::vector<double> &output, Body body) {
+  double best = 0.0;
+  for (int repetition = 0; repetition < nRepetitions; ++repetition) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto stop = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    if (repetition == 0 || seconds < best) {
+      best = seconds;
+    }
+  }
+
+  double checksum = 0.0;
+  for (double value : output) {
+    checksum += value;
+  }
+
+  double nsPerEvent = best * 1e9 / nEvents;
+  std::printf("%-34s %10.2f %14.4g %16.8g\n", name.c_str(), nsPerEvent,
+              nEvents / best, checksum);
+}
+
+/* Distance of two angles on the circle */
+double angularDistance(double a, double b) {
+  double distance = std::fabs(a - b);
+  return std::min(distance, 2 * M_PI - distance);
+}
+
+/* Largest difference of the two phiCP methods the cross-check accepts */
+const double CROSS_CHECK_TOLERANCE = 1e-9;
+
+/**
+ * Prints the largest difference of the two methods over all events, false if
+ * it exceeds the tolerance
+ */
+template <typename Boosted, typename Invariant>
+bool crossCheck(const std::string &name, std::size_t nEvents, Boosted boosted,
+                Invariant invariant) {
+  double maxDistance = 0.0;
+  for (std::size_t i = 0; i < nEvents; ++i) {
+    maxDistance =
+        std::max(maxDistance, angularDistance(boosted(i), invariant(i)));
+  }
+  const bool passed = maxDistance <= CROSS_CHECK_TOLERANCE;
+  std::printf("%-34s %10.3g%s\n", name.c_str(), maxDistance,
+              passed ? "" : "  FAILED");
+  return passed;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::size_t nEvents = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  int nRepetitions = argc > 2 ? std::atoi(argv[2]) : 5;
+  if (nEvents == 0 || nRepetitions <= 0) {
+    std::fprintf(stderr, "Usage: %s [nEvents] [nRepetitions]\n", argv[0]);
+    return 1;
+  }
+
+  const SyntheticEvents events(nEvents);
+  std::vector<double> output(nEvents);
+
+  std::printf("%zu events, best of %d repetitions\n\n", nEvents, nRepetitions);
+  std::printf("%-34s %10s %14s %16s\n", "Kernel", "ns/event", "events/s",
+              "checksum");
+
+  measure("phiCP_ImpactParameter", nEvents, nRepetitions, output, [&] {
+    for (std::size_t i = 0; i < nEvents; ++i) {
+      output[i] = phiCP_ImpactParameter(
+          events.pionPosImpactParam.get(i), events.pionNegImpactParam.get(i),
+          events.pionPosP4.get(i), events.pionNegP4.get(i),
+          events.ipFrame.get(i));
+    }
+  });
+
+  measure("phiCP_ImpactParameter_Batch", nEvents, nRepetitions, output, [&] {
+    phiCP_ImpactParameter_Batch(
+        nEvents, events.pionPosImpactParam.arrays(),
+        events.pionNegImpactParam.arrays(), events.pionPosP4.arrays(),
+        events.pionNegP4.arrays(), events.ipFrame.arrays(), output.data());
+  });
+
+  measure("phiCP_Pion_RhoDecayPlane", nEvents, nRepetitions, output, [&] {
+    for (std::size_t i = 0; i < nEvents; ++i) {
+      output[i] = phiCP_Pion_RhoDecayPlane(
+          events.pionPosP4.get(i), events.pionNeuPosP4.get(i),
+          events.pionNegP4.get(i), events.pionNeuNegP4.get(i),
+          events.rhoFrame.get(i));
+    }
+  });
+
+  measure("phiCP_Pion_RhoDecayPlane_Batch", nEvents, nRepetitions, output,
+          [&] {
+            phiCP_Pion_RhoDecayPlane_Batch(
+                nEvents, events.pionPosP4.arrays(),
+                events.pionNeuPosP4.arrays(), events.pionNegP4.arrays(),
+                events.pionNeuNegP4.arrays(), events.rhoFrame.arrays(),
+                output.data());
+          });
+
+  measure("phiCP_IP_Rho", nEvents, nRepetitions, output, [&] {
+    for (std::size_t i = 0; i < nEvents; ++i) {
+      output[i] = phiCP_IP_Rho(
+          events.pionNegImpactParam.get(i), events.pionNegP4.get(i),
+          events.pionPosP4.get(i), events.pionNeuPosP4.get(i),
+          events.rhoFrame.get(i), true);
+    }
+  });
+
+  measure("phiCP_IP_Rho_Batch", nEvents, nRepetitions, output, [&] {
+    phiCP_IP_Rho_Batch(nEvents, events.pionNegImpactParam.arrays(),
+                       events.pionNegP4.arrays(), events.pionPosP4.arrays(),
+                       events.pionNeuPosP4.arrays(), events.rhoFrame.arrays(),
+                       true, output.data());
+  });
+
+  measure("phiCP_ImpactParameter_Invariant", nEvents, nRepetitions, output,
+          [&] {
+            for (std::size_t i = 0; i < nEvents; ++i) {
+              output[i] = phiCP_ImpactParameter<double, PHICP_INVARIANT>(
+                  events.pionPosImpactParam.get(i),
+                  events.pionNegImpactParam.get(i), events.pionPosP4.get(i),
+                  events.pionNegP4.get(i), events.ipFrame.get(i));
+            }
+          });
+
+  measure("phiCP_Pion_RhoDecayPlane_Invariant", nEvents, nRepetitions, output,
+          [&] {
+            for (std::size_t i = 0; i < nEvents; ++i) {
+              output[i] = phiCP_Pion_RhoDecayPlane<double, PHICP_INVARIANT>(
+                  events.pionPosP4.get(i), events.pionNeuPosP4.get(i),
+                  events.pionNegP4.get(i), events.pionNeuNegP4.get(i),
+                  events.rhoFrame.get(i));
+            }
+          });
+
+  measure("phiCP_IP_Rho_Invariant", nEvents, nRepetitions, output, [&] {
+    for (std::size_t i = 0; i < nEvents; ++i) {
+      output[i] = phiCP_IP_Rho<double, PHICP_INVARIANT>(
+          events.pionNegImpactParam.get(i), events.pionNegP4.get(i),
+          events.pionPosP4.get(i), events.pionNeuPosP4.get(i),
+          events.rhoFrame.get(i), true);
+    }
+  });
+
+  measure("calculateImpactParameter", nEvents, nRepetitions, output, [&] {
+    for (std::size_t i = 0; i < nEvents; ++i) {
+      output[i] = calculateImpactParameter(events.pionPosImpactParam.get(i),
+                                           events.pionPosP4.get(i).vect(),
+                                           events.pionNegImpactParam.get(i))
+                      .mag2();
+    }
+  });
+
+  measure("upsilon", nEvents, nRepetitions, output, [&] {
+    for (std::size_t i = 0; i < nEvents; ++i) {
+      output[i] = upsilon(events.pionPosP4.e[i], events.pionNeuPosP4.e[i]);
+    }
+  });
+
+  const std::size_t nReplicas = 100;
+  std::vector<float> weights(nReplicas);
+  BootstrapReplicas replicas(nReplicas);
+  measure("BootstrapReplicas (100 replicas)", nEvents, nRepetitions, output,
+          [&] {
+            for (std::size_t i = 0; i < nEvents; ++i) {
+              BootstrapReplicas::eventWeights(i, 0, nReplicas, weights.data());
+              replicas.add(events.pionPosP4.px[i], weights.data());
+              output[i] = weights[0];
+            }
+          });
+
+  std::printf("\nLargest difference of the invariant and boosted phiCP "
+              "(rad)\n\n");
+  bool passed = true;
+  passed &= crossCheck("phiCP_ImpactParameter", nEvents, [&](std::size_t i) {
+    return phiCP_ImpactParameter<double, PHICP_BOOSTED>(
+        events.pionPosImpactParam.get(i), events.pionNegImpactParam.get(i),
+        events.pionPosP4.get(i), events.pionNegP4.get(i),
+        events.ipFrame.get(i));
+  }, [&](std::size_t i) {
+    return phiCP_ImpactParameter<double, PHICP_INVARIANT>(
+        events.pionPosImpactParam.get(i), events.pionNegImpactParam.get(i),
+        events.pionPosP4.get(i), events.pionNegP4.get(i),
+        events.ipFrame.get(i));
+  });
+
+  passed &= crossCheck("phiCP_Pion_RhoDecayPlane", nEvents, [&](std::size_t i) {
+    return phiCP_Pion_RhoDecayPlane<double, PHICP_BOOSTED>(
+        events.pionPosP4.get(i), events.pionNeuPosP4.get(i),
+        events.pionNegP4.get(i), events.pionNeuNegP4.get(i),
+        events.rhoFrame.get(i));
+  }, [&](std::size_t i) {
+    return phiCP_Pion_RhoDecayPlane<double, PHICP_INVARIANT>(
+        events.pionPosP4.get(i), events.pionNeuPosP4.get(i),
+        events.pionNegP4.get(i), events.pionNeuNegP4.get(i),
+        events.rhoFrame.get(i));
+  });
+
+  for (bool rhoIsPositive : {true, false}) {
+    passed &= crossCheck(
+        rhoIsPositive ? "phiCP_IP_Rho (rho+)" : "phiCP_IP_Rho (rho-)", nEvents,
+        [&](std::size_t i) {
+      return phiCP_IP_Rho<double, PHICP_BOOSTED>(
+          events.pionNegImpactParam.get(i), events.pionNegP4.get(i),
+          events.pionPosP4.get(i), events.pionNeuPosP4.get(i),
+          events.rhoFrame.get(i), rhoIsPositive);
+    }, [&](std::size_t i) {
+      return phiCP_IP_Rho<double, PHICP_INVARIANT>(
+          events.pionNegImpactParam.get(i), events.pionNegP4.get(i),
+          events.pionPosP4.get(i), events.pionNeuPosP4.get(i),
+          events.rhoFrame.get(i), rhoIsPositive);
+    });
+  }
+
+  if (!passed) {
+    std::printf("\nThe phiCP methods differ by more than %g rad\n",
+                CROSS_CHECK_TOLERANCE);
+    return 1;
+  }
+  return 0;
+}
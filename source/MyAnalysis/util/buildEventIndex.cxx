@@ -0,0 +1,157 @@
+/**
+ * Writes the event index sidecar of xAOD input files: the truth decay modes
+ * of the tau pair of every entry, see EventIndex. Only the truth containers
+ * are read. Inputs whose sidecar is newer than the input are skipped, unless
+ * --force is given. The sidecars are written next to the inputs, or below
+ * --output-dir for read-only sample directories.
+ *
+ * Jobs run with a channel filter, e.g. ATestRun_eljob.py --channels
+ * 1p0n_1p0n, then only read the containers of the entries of these channels.
+ * Pass the same --event-index-dir as the --output-dir here.
+ *
+ * Usage: buildEventIndex [--force] [--output-dir <dir>] <input> [...]
+ */
+
+#include "xAODRootAccess/Init.h"
+#include "xAODRootAccess/TEvent.h"
+#include "xAODTruth/TruthParticleContainer.h"
+#include <MyAnalysis/EventIndex.h>
+#include <MyAnalysis/TauPairProcessor.h>
+#include <MyAnalysis/TruthDecayIndex.h>
+#include <TFile.h>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace {
+
+/* Whether the sidecar exists and was written after the input */
+bool isUpToDate(const std::string &inputPath, const std::string &outputDir) {
+  namespace fs = std::filesystem;
+  std::error_code error;
+  fs::file_time_type indexTime = fs::last_write_time(
+      EventIndex::sidecarPath(inputPath, outputDir), error);
+  if (error) {
+    return false;
+  }
+  fs::file_time_type inputTime = fs::last_write_time(inputPath, error);
+  return !error && indexTime >= inputTime;
+}
+
+bool indexFile(const std::string &inputPath, const std::string &outputDir) {
+  std::unique_ptr<TFile> file(TFile::Open(inputPath.c_str()));
+  if (!file || file->IsZombie()) {
+    std::fprintf(stderr, "Failed to open %s\n", inputPath.c_str());
+    return false;
+  }
+
+  xAOD::TEvent event(xAOD::TEvent::kClassAccess);
+  if (event.readFrom(file.get()).isFailure()) {
+    std::fprintf(stderr, "Failed to read %s\n", inputPath.c_str());
+    return false;
+  }
+
+  TruthDecayIndex truthDecays;
+  EventIndex index;
+  unsigned long long channelCounts[CHANNEL_COUNT] = {};
+  const long long entries = event.getEntries();
+  for (long long entry = 0; entry < entries; entry++) {
+    if (event.getEntry(entry) < 0) {
+      std::fprintf(stderr, "Failed to read entry %lld of %s\n", entry,
+                   inputPath.c_str());
+      return false;
+    }
+
+    // The same Higgs fallback as TruthLevelAnalysis::execute()
+    const xAOD::TruthParticleContainer *truthHiggs = nullptr;
+    if (event.contains<xAOD::TruthParticleContainer>(
+            "TruthBSMWithDecayParticles")) {
+      event.retrieve(truthHiggs, "TruthBSMWithDecayParticles").ignore();
+    }
+    if (truthHiggs == nullptr || truthHiggs->empty()) {
+      if (event.retrieve(truthHiggs, "TruthBosonsWithDecayParticles")
+              .isFailure()) {
+        return false;
+      }
+    }
+
+    truthDecays.findHiggsDecay(truthHiggs);
+    if (truthDecays.higgs() == nullptr || !truthDecays.hasTauPair()) {
+      index.add(UNKNOWN, UNKNOWN);
+      channelCounts[CHANNEL_NONE]++;
+      continue;
+    }
+
+    const xAOD::TruthParticleContainer *truthTaus = nullptr;
+    if (event.retrieve(truthTaus, "TruthTausWithDecayParticles")
+            .isFailure()) {
+      return false;
+    }
+    truthDecays.indexTauDecays(truthTaus);
+
+    TauDecayMode tauNeg = truthDecays.tauNeg().decayMode;
+    TauDecayMode tauPos = truthDecays.tauPos().decayMode;
+    index.add(tauNeg, tauPos);
+    channelCounts[decayChannelOf(tauNeg, tauPos)]++;
+  }
+
+  const std::string indexPath = EventIndex::sidecarPath(inputPath, outputDir);
+  std::error_code error;
+  std::filesystem::create_directories(
+      std::filesystem::path(indexPath).parent_path(), error);
+  if (error || !index.write(indexPath)) {
+    std::fprintf(stderr, "Failed to write %s\n", indexPath.c_str());
+    return false;
+  }
+
+  std::printf("%s: %lld entries\n", indexPath.c_str(), entries);
+  for (int channel = 0; channel < CHANNEL_COUNT; channel++) {
+    if (channelCounts[channel] > 0) {
+      std::printf("  %-12s %llu\n",
+                  decayChannelName(static_cast<DecayChannel>(channel)),
+                  channelCounts[channel]);
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  int first = 1;
+  bool force = false;
+  std::string outputDir;
+  while (first < argc) {
+    std::string option = argv[first];
+    if (option == "--force") {
+      force = true;
+    } else if (option == "--output-dir" && first + 1 < argc) {
+      outputDir = argv[++first];
+    } else {
+      break;
+    }
+    first++;
+  }
+  if (first >= argc) {
+    std::fprintf(stderr,
+                 "Usage: %s [--force] [--output-dir <dir>] <input> [...]\n",
+                 argv[0]);
+    return 1;
+  }
+
+  if (xAOD::Init().isFailure()) {
+    return 1;
+  }
+
+  int result = 0;
+  for (int i = first; i < argc; i++) {
+    if (!force && isUpToDate(argv[i], outputDir)) {
+      continue;
+    }
+    if (!indexFile(argv[i], outputDir)) {
+      result = 1;
+    }
+  }
+  return result;
+}
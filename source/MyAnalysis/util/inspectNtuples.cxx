@@ -0,0 +1,304 @@
+/**
+ * Inspector of the inputs and outputs of the analysis, printing the reports of
+ * Count_branches.py and Count_events.py.
+ *
+ * branches: counts the valid (not -99) entries of every tau_analysis branch,
+ * reading each ntuple once. With --stats the minimum, maximum and mean of the
+ * valid values are added to every line.
+ *
+ * events: counts the events of every sample from the tree headers of its
+ * input files, without reading any event.
+ *
+ * All samples are processed in parallel, the report keeps their order.
+ *
+ * Usage: inspectNtuples branches [--stats] <sample> <ntuple> [...]
+ *        inspectNtuples events <sample> <directory> [...]
+ */
+
+#include <MyAnalysis/NtupleColumns.h>
+#include <ROOT/RDFHelpers.hxx>
+#include <ROOT/RDataFrame.hxx>
+#include <TFile.h>
+#include <TROOT.h>
+#include <TStatistic.h>
+#include <TTree.h>
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char *const NTUPLE_NAME = "tau_analysis";
+const char *const EVENT_TREE_NAMES[] = {"CollectionTree", "tau_analysis",
+                                        "nominal"};
+
+struct Sample {
+  std::string name;
+  std::string path;
+};
+
+std::string format(const char *fmt, ...) {
+  char buffer[1024];
+  va_list args;
+  va_start(args, fmt);
+  std::vsnprintf(buffer, sizeof(buffer), fmt, args);
+  va_end(args);
+  return buffer;
+}
+
+/* The integer with thousands separators, as Python's "{:,}" */
+std::string withCommas(long long value) {
+  std::string digits = std::to_string(value < 0 ? -value : value);
+  std::string result;
+  for (std::size_t i = 0; i < digits.size(); i++) {
+    if (i > 0 && (digits.size() - i) % 3 == 0) {
+      result += ',';
+    }
+    result += digits[i];
+  }
+  return value < 0 ? "-" + result : result;
+}
+
+struct BranchReport {
+  std::string name;
+  ROOT::RDF::RResultPtr<TStatistic> stats;
+};
+
+struct NtupleReport {
+  std::string error;
+  std::unique_ptr<ROOT::RDataFrame> frame;
+  ROOT::RDF::RResultPtr<ULong64_t> entries;
+  std::vector<BranchReport> branches;
+};
+
+/* Books the statistics of every branch, run later together with the others */
+void bookNtuple(const Sample &sample, NtupleReport &report) {
+  if (!std::filesystem::exists(sample.path)) {
+    report.error = "File not found at " + sample.path;
+    return;
+  }
+
+  {
+    std::unique_ptr<TFile> file(TFile::Open(sample.path.c_str()));
+    if (!file || file->IsZombie()) {
+      report.error = "Failed to open file";
+      return;
+    }
+    if (file->GetKey(NTUPLE_NAME) == nullptr) {
+      report.error = std::string("Tree '") + NTUPLE_NAME + "' not found";
+      return;
+    }
+  }
+
+  try {
+    report.frame =
+        std::make_unique<ROOT::RDataFrame>(NTUPLE_NAME, sample.path);
+    ROOT::RDF::RNode node = defineWideColumns(*report.frame);
+    report.entries = node.Count();
+
+    for (const std::string &column : node.GetColumnNames()) {
+      if (isCompactColumn(column)) {
+        continue;
+      }
+      ROOT::RDF::RResultPtr<TStatistic> stats =
+          defineDouble(node, "value", column)
+              .Filter([](double value) { return value != -99.0; }, {"value"})
+              .Stats("value");
+      report.branches.push_back({column, stats});
+    }
+  } catch (const std::exception &e) {
+    report.error = std::string("Error - ") + e.what();
+    report.branches.clear();
+  }
+
+  std::sort(report.branches.begin(), report.branches.end(),
+            [](const BranchReport &a, const BranchReport &b) {
+              return a.name < b.name;
+            });
+}
+
+int inspectBranches(const std::vector<Sample> &samples, bool printStats) {
+  std::printf("Counting events per branch in all processed samples...\n");
+  std::printf("%s\n", std::string(80, '=').c_str());
+
+  // All ntuples are read in one event loop using the implicit MT pool
+  ROOT::EnableImplicitMT();
+  std::vector<NtupleReport> reports(samples.size());
+  std::vector<ROOT::RDF::RResultHandle> handles;
+  for (std::size_t i = 0; i < samples.size(); i++) {
+    bookNtuple(samples[i], reports[i]);
+    if (!reports[i].error.empty()) {
+      continue;
+    }
+    handles.emplace_back(reports[i].entries);
+    for (const BranchReport &branch : reports[i].branches) {
+      handles.emplace_back(branch.stats);
+    }
+  }
+
+  try {
+    if (!handles.empty()) {
+      ROOT::RDF::RunGraphs(handles);
+    }
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "Failed to read the ntuples: %s\n", e.what());
+    return 1;
+  }
+
+  for (std::size_t i = 0; i < samples.size(); i++) {
+    const NtupleReport &report = reports[i];
+    if (!report.error.empty()) {
+      std::printf("%-25s: %s\n", samples[i].name.c_str(),
+                  report.error.c_str());
+      continue;
+    }
+
+    std::printf("\n%s:\n", samples[i].name.c_str());
+    std::printf("%s\n", std::string(50, '-').c_str());
+
+    long long total = *report.entries;
+    for (const BranchReport &branch : report.branches) {
+      long long count = branch.stats->GetN();
+      double percentage = total > 0 ? 100.0 * count / total : 0.0;
+      std::string line = format("  %-30s: %8s / %8s (%5.1f%%)",
+                                branch.name.c_str(), withCommas(count).c_str(),
+                                withCommas(total).c_str(), percentage);
+      if (printStats && count > 0) {
+        line += format("  min %10.4g  max %10.4g  mean %10.4g",
+                       branch.stats->GetMin(), branch.stats->GetMax(),
+                       branch.stats->GetMean());
+      }
+      std::printf("%s\n", line.c_str());
+    }
+  }
+
+  std::printf("\n%s\n", std::string(80, '=').c_str());
+  std::printf("Branch counting completed!\n");
+  std::printf("\nNote: Counts show valid entries (not equal to -99.0) vs "
+              "total entries per branch.\n");
+  return 0;
+}
+
+/* Report lines of one sample, only the tree headers are read */
+std::string countEvents(const Sample &sample) {
+  namespace fs = std::filesystem;
+
+  if (!fs::is_directory(sample.path)) {
+    return format("%-25s: Directory not found at %s\n", sample.name.c_str(),
+                  sample.path.c_str());
+  }
+
+  std::vector<std::string> fileNames;
+  for (const fs::directory_entry &entry : fs::directory_iterator(sample.path)) {
+    std::string fileName = entry.path().filename().string();
+    if (fileName.size() >= 7 &&
+        fileName.compare(fileName.size() - 7, 7, ".root.1") == 0) {
+      fileNames.push_back(fileName);
+    }
+  }
+  std::sort(fileNames.begin(), fileNames.end());
+
+  if (fileNames.empty()) {
+    return format("%-25s: No ROOT files found in %s\n", sample.name.c_str(),
+                  sample.path.c_str());
+  }
+
+  std::string report;
+  long long totalEvents = 0;
+  int fileCount = 0;
+  for (const std::string &fileName : fileNames) {
+    std::string path = (fs::path(sample.path) / fileName).string();
+    std::unique_ptr<TFile> file(TFile::Open(path.c_str()));
+    if (!file || file->IsZombie()) {
+      report += "  Warning: Failed to open " + fileName + "\n";
+      continue;
+    }
+
+    TTree *tree = nullptr;
+    for (const char *treeName : EVENT_TREE_NAMES) {
+      tree = file->Get<TTree>(treeName);
+      if (tree != nullptr) {
+        break;
+      }
+    }
+    if (tree == nullptr) {
+      report += "  Warning: No recognized tree found in " + fileName + "\n";
+      continue;
+    }
+
+    totalEvents += tree->GetEntries();
+    fileCount++;
+  }
+
+  if (fileCount > 0) {
+    report += format("%-25s: %10s events (%d files)\n", sample.name.c_str(),
+                     withCommas(totalEvents).c_str(), fileCount);
+  } else {
+    report += format("%-25s: No valid files processed\n", sample.name.c_str());
+  }
+  return report;
+}
+
+int inspectEvents(const std::vector<Sample> &samples) {
+  std::printf("Counting events in all samples...\n");
+  std::printf("%s\n", std::string(50, '=').c_str());
+
+  ROOT::EnableThreadSafety();
+  std::vector<std::future<std::string>> reports;
+  for (const Sample &sample : samples) {
+    reports.push_back(std::async(std::launch::async, countEvents, sample));
+  }
+  for (std::future<std::string> &report : reports) {
+    std::printf("%s", report.get().c_str());
+  }
+
+  std::printf("%s\n", std::string(50, '=').c_str());
+  std::printf("Event counting completed!\n");
+  return 0;
+}
+
+int usage(const char *program) {
+  std::fprintf(stderr,
+               "Usage: %s branches [--stats] <sample> <ntuple> [...]\n"
+               "       %s events <sample> <directory> [...]\n",
+               program, program);
+  return 1;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    return usage(argv[0]);
+  }
+
+  std::string mode = argv[1];
+  int first = 2;
+  bool printStats = false;
+  if (mode == "branches" && argc > 2 && std::string(argv[2]) == "--stats") {
+    printStats = true;
+    first = 3;
+  }
+
+  if ((argc - first) % 2 != 0) {
+    return usage(argv[0]);
+  }
+  std::vector<Sample> samples;
+  for (int i = first; i < argc; i += 2) {
+    samples.push_back({argv[i], argv[i + 1]});
+  }
+
+  if (mode == "branches") {
+    return inspectBranches(samples, printStats);
+  }
+  if (mode == "events") {
+    return inspectEvents(samples);
+  }
+  return usage(argv[0]);
+}